@@ -0,0 +1,521 @@
+#include "MaxFlow.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+const Vertex kNoVertex = std::numeric_limits<Vertex>::max();
+
+}  // namespace
+
+MaxFlowNetwork::MaxFlowNetwork(size_t num_vertices)
+    : num_vertices_(num_vertices) {}
+
+size_t MaxFlowNetwork::AddEdge(Vertex from, Vertex to, Capacity capacity) {
+  assert(from < VerticesCount() && to < VerticesCount());
+  assert(capacity >= 0);
+  edge_tails_.push_back(from);
+  edge_heads_.push_back(to);
+  edge_capacities_.push_back(capacity);
+  built_ = false;
+  solved_ = false;
+  return EdgesCount() - 1;
+}
+
+void MaxFlowNetwork::Build() {
+  offsets_.assign(num_vertices_ + 1, 0);
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    ++offsets_[edge_tails_[edge] + 1];
+    ++offsets_[edge_heads_[edge] + 1];
+  }
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    offsets_[vertex + 1] += offsets_[vertex];
+  }
+  size_t num_arcs = offsets_.back();
+  heads_.resize(num_arcs);
+  reverse_.resize(num_arcs);
+  capacities_.resize(num_arcs);
+  edge_arcs_.resize(EdgesCount());
+  auto position = std::vector<size_t>(offsets_.begin(), offsets_.end() - 1);
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    Vertex from = edge_tails_[edge];
+    Vertex to = edge_heads_[edge];
+    size_t forward = position[from]++;
+    size_t backward = position[to]++;
+    heads_[forward] = to;
+    heads_[backward] = from;
+    reverse_[forward] = backward;
+    reverse_[backward] = forward;
+    capacities_[forward] = edge_capacities_[edge];
+    capacities_[backward] = 0;
+    edge_arcs_[edge] = forward;
+  }
+  built_ = true;
+}
+
+Capacity MaxFlowNetwork::FindMaxFlow(Vertex source, Vertex sink,
+                                     MaxFlowAlgorithm algorithm) {
+  assert(source < VerticesCount() && sink < VerticesCount());
+  if (!built_) {
+    Build();
+  }
+  residual_ = capacities_;
+  source_ = source;
+  sink_ = sink;
+  solved_ = true;
+  flow_value_ = 0;
+  if (source == sink) {
+    return 0;
+  }
+  switch (algorithm) {
+    case MaxFlowAlgorithm::Dinic:
+      flow_value_ = Dinic(source, sink);
+      break;
+    case MaxFlowAlgorithm::PushRelabel:
+      flow_value_ = PushRelabel(source, sink);
+      break;
+    default:
+      assert(false);
+  }
+  return flow_value_;
+}
+
+Capacity MaxFlowNetwork::UpdateCapacities(
+    const std::vector<CapacityUpdate>& updates) {
+  assert(solved_);
+  excess_.assign(num_vertices_, 0);
+  for (const auto& update : updates) {
+    assert(update.edge < EdgesCount() && update.capacity >= 0);
+    size_t arc = edge_arcs_[update.edge];
+    Capacity flow = capacities_[arc] - residual_[arc];
+    Capacity kept = std::min(flow, update.capacity);
+    // The overflow leaves a surplus at the tail and a shortage at the head
+    excess_[edge_tails_[update.edge]] += flow - kept;
+    excess_[edge_heads_[update.edge]] -= flow - kept;
+    edge_capacities_[update.edge] = update.capacity;
+    capacities_[arc] = update.capacity;
+    residual_[arc] = update.capacity - kept;
+    residual_[reverse_[arc]] = kept;
+  }
+  if (source_ == sink_) {
+    return 0;
+  }
+  // The source and the sink may gain or lose flow freely
+  excess_[source_] = 0;
+  excess_[sink_] = 0;
+  Reroute(kNoVertex, kNoVertex);
+  // What is left lies on flow paths or cycles through the source or the
+  // sink; pass it on where that keeps the flow value, else cancel it
+  Reroute(kNoVertex, sink_);
+  Reroute(kNoVertex, source_);
+  Reroute(source_, kNoVertex);
+  Reroute(sink_, kNoVertex);
+  Dinic(source_, sink_);
+  flow_value_ = NetOutflow(source_);
+  return flow_value_;
+}
+
+Capacity MaxFlowNetwork::Flow(size_t edge) const {
+  assert(built_ && edge < EdgesCount());
+  size_t arc = edge_arcs_[edge];
+  return capacities_[arc] - residual_[arc];
+}
+
+std::vector<bool> MaxFlowNetwork::MinCutSide() const {
+  assert(solved_);
+  auto side = std::vector<bool>(num_vertices_, false);
+  side[source_] = true;
+  std::vector<Vertex> stack(1, source_);
+  while (!stack.empty()) {
+    Vertex vertex = stack.back();
+    stack.pop_back();
+    for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+      if (residual_[arc] > 0 && !side[heads_[arc]]) {
+        side[heads_[arc]] = true;
+        stack.push_back(heads_[arc]);
+      }
+    }
+  }
+  return side;
+}
+
+std::vector<size_t> MaxFlowNetwork::MinCutEdges() const {
+  auto side = MinCutSide();
+  std::vector<size_t> edges;
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    if (side[edge_tails_[edge]] && !side[edge_heads_[edge]]) {
+      edges.push_back(edge);
+    }
+  }
+  return edges;
+}
+
+void MaxFlowNetwork::Reroute(Vertex from, Vertex to) {
+  auto is_target = [&](Vertex vertex) {
+    return to == kNoVertex ? excess_[vertex] < 0 : vertex == to;
+  };
+  // current_ holds the arc each vertex was reached by
+  const size_t kUnseen = kNoLevel;
+  const size_t kRoot = kNoLevel - 1;
+  while (true) {
+    current_.assign(num_vertices_, kUnseen);
+    queue_.clear();
+    for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+      if (from == kNoVertex ? excess_[vertex] > 0 : vertex == from) {
+        current_[vertex] = kRoot;
+        queue_.push_back(vertex);
+      }
+    }
+    Vertex target = kNoVertex;
+    for (size_t head = 0; head < queue_.size() && target == kNoVertex;
+         ++head) {
+      Vertex vertex = queue_[head];
+      for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+        Vertex next = heads_[arc];
+        if (residual_[arc] > 0 && current_[next] == kUnseen) {
+          current_[next] = arc;
+          if (is_target(next)) {
+            target = next;
+            break;
+          }
+          queue_.push_back(next);
+        }
+      }
+    }
+    if (target == kNoVertex) {
+      return;
+    }
+
+    Capacity amount = std::numeric_limits<Capacity>::max();
+    if (to == kNoVertex) {
+      amount = -excess_[target];
+    }
+    Vertex root = target;
+    for (; current_[root] != kRoot; root = heads_[reverse_[current_[root]]]) {
+      amount = std::min(amount, residual_[current_[root]]);
+    }
+    if (from == kNoVertex) {
+      amount = std::min(amount, excess_[root]);
+    }
+    for (Vertex vertex = target; vertex != root;
+         vertex = heads_[reverse_[current_[vertex]]]) {
+      Push(current_[vertex], amount);
+    }
+    if (from == kNoVertex) {
+      excess_[root] -= amount;
+    }
+    if (to == kNoVertex) {
+      excess_[target] += amount;
+    }
+  }
+}
+
+Capacity MaxFlowNetwork::NetOutflow(Vertex vertex) const {
+  Capacity outflow = 0;
+  for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+    outflow += capacities_[arc] - residual_[arc];
+  }
+  return outflow;
+}
+
+Capacity MaxFlowNetwork::Dinic(Vertex source, Vertex sink) {
+  Capacity total = 0;
+  while (BuildLevels(source, sink)) {
+    current_.assign(offsets_.begin(), offsets_.end() - 1);
+    total += BlockingFlow(source, sink);
+  }
+  return total;
+}
+
+bool MaxFlowNetwork::BuildLevels(Vertex source, Vertex sink) {
+  level_.assign(num_vertices_, kNoLevel);
+  level_[source] = 0;
+  queue_.assign(1, source);
+  for (size_t head = 0; head < queue_.size(); ++head) {
+    Vertex vertex = queue_[head];
+    // Nothing past the sink's level lies on a shortest path
+    if (level_[sink] != kNoLevel && level_[vertex] >= level_[sink]) {
+      break;
+    }
+    for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+      Vertex next = heads_[arc];
+      if (residual_[arc] > 0 && level_[next] == kNoLevel) {
+        level_[next] = level_[vertex] + 1;
+        queue_.push_back(next);
+      }
+    }
+  }
+  return level_[sink] != kNoLevel;
+}
+
+Capacity MaxFlowNetwork::BlockingFlow(Vertex source, Vertex sink) {
+  Capacity total = 0;
+  path_.clear();
+  Vertex vertex = source;
+  while (true) {
+    if (vertex == sink) {
+      Capacity amount = residual_[path_.front()];
+      for (auto arc : path_) {
+        amount = std::min(amount, residual_[arc]);
+      }
+      for (auto arc : path_) {
+        Push(arc, amount);
+      }
+      total += amount;
+      // Resume from the tail of the first saturated arc
+      size_t keep = 0;
+      while (residual_[path_[keep]] > 0) {
+        ++keep;
+      }
+      path_.resize(keep);
+      vertex = path_.empty() ? source : heads_[path_.back()];
+      continue;
+    }
+    size_t& arc = current_[vertex];
+    while (arc < ArcsEnd(vertex) &&
+           (residual_[arc] == 0 ||
+            level_[heads_[arc]] != level_[vertex] + 1)) {
+      ++arc;
+    }
+    if (arc < ArcsEnd(vertex)) {
+      path_.push_back(arc);
+      vertex = heads_[arc];
+      continue;
+    }
+    // A dead end for the rest of the phase: step back and skip the arc in
+    if (vertex == source) {
+      break;
+    }
+    path_.pop_back();
+    vertex = path_.empty() ? source : heads_[path_.back()];
+    ++current_[vertex];
+  }
+  return total;
+}
+
+Capacity MaxFlowNetwork::PushRelabel(Vertex source, Vertex sink) {
+  excess_.assign(num_vertices_, 0);
+  level_.assign(num_vertices_, 0);
+  for (size_t arc = ArcsBegin(source); arc < ArcsEnd(source); ++arc) {
+    Capacity amount = residual_[arc];
+    if (amount > 0) {
+      Push(arc, amount);
+      excess_[heads_[arc]] += amount;
+      excess_[source] -= amount;
+    }
+  }
+  GlobalRelabel(source, sink);
+
+  // Heights reach num_vertices_ only once the sink is out of reach, so
+  // the preflow is maximum when no active vertex is below that
+  while (true) {
+    while (highest_active_ > 0 && active_[highest_active_].empty()) {
+      --highest_active_;
+    }
+    if (active_[highest_active_].empty()) {
+      break;
+    }
+    size_t height = highest_active_;
+    Vertex vertex = active_[height].back();
+    active_[height].pop_back();
+    if (level_[vertex] != height || excess_[vertex] == 0) {
+      continue;
+    }
+    Discharge(vertex, source, sink);
+    if (relabels_since_global_ >= num_vertices_) {
+      GlobalRelabel(source, sink);
+    }
+  }
+  Capacity flow = excess_[sink];
+  ReturnExcess(source, sink);
+  return flow;
+}
+
+void MaxFlowNetwork::GlobalRelabel(Vertex source, Vertex sink) {
+  // Exact heights: residual distances to the sink, found backwards
+  level_.assign(num_vertices_, num_vertices_);
+  level_[sink] = 0;
+  queue_.assign(1, sink);
+  for (size_t head = 0; head < queue_.size(); ++head) {
+    Vertex vertex = queue_[head];
+    for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+      Vertex prev = heads_[arc];
+      if (prev != source && level_[prev] == num_vertices_ &&
+          residual_[reverse_[arc]] > 0) {
+        level_[prev] = level_[vertex] + 1;
+        queue_.push_back(prev);
+      }
+    }
+  }
+
+  current_.assign(offsets_.begin(), offsets_.end() - 1);
+  bucket_head_.assign(num_vertices_, kNoVertex);
+  bucket_next_.resize(num_vertices_);
+  bucket_prev_.resize(num_vertices_);
+  highest_linked_ = 0;
+  active_.resize(num_vertices_);
+  for (auto& active : active_) {
+    active.clear();
+  }
+  highest_active_ = 0;
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    if (vertex != source && level_[vertex] < num_vertices_) {
+      Link(vertex);
+      if (vertex != sink && excess_[vertex] > 0) {
+        AddActive(vertex);
+      }
+    }
+  }
+  relabels_since_global_ = 0;
+}
+
+void MaxFlowNetwork::Discharge(Vertex vertex, Vertex source, Vertex sink) {
+  while (excess_[vertex] > 0) {
+    if (current_[vertex] == ArcsEnd(vertex)) {
+      Relabel(vertex);
+      if (level_[vertex] >= num_vertices_) {
+        return;
+      }
+      continue;
+    }
+    size_t arc = current_[vertex];
+    Vertex next = heads_[arc];
+    if (residual_[arc] > 0 && level_[vertex] == level_[next] + 1) {
+      Capacity amount = std::min(excess_[vertex], residual_[arc]);
+      if (excess_[next] == 0 && next != sink && next != source) {
+        AddActive(next);
+      }
+      Push(arc, amount);
+      excess_[vertex] -= amount;
+      excess_[next] += amount;
+    } else {
+      ++current_[vertex];
+    }
+  }
+}
+
+void MaxFlowNetwork::Relabel(Vertex vertex) {
+  ++relabels_since_global_;
+  size_t height = level_[vertex];
+  Unlink(vertex);
+  if (bucket_head_[height] == kNoVertex) {
+    // Nothing is left at this height, so nothing above it can reach the
+    // sink any more
+    level_[vertex] = num_vertices_;
+    Gap(height);
+    return;
+  }
+  size_t lowest = num_vertices_;
+  for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+    if (residual_[arc] > 0) {
+      lowest = std::min(lowest, level_[heads_[arc]] + 1);
+    }
+  }
+  level_[vertex] = lowest;
+  current_[vertex] = ArcsBegin(vertex);
+  if (lowest < num_vertices_) {
+    Link(vertex);
+  }
+}
+
+void MaxFlowNetwork::Gap(size_t height) {
+  for (size_t above = height + 1; above <= highest_linked_; ++above) {
+    for (Vertex vertex = bucket_head_[above]; vertex != kNoVertex;
+         vertex = bucket_next_[vertex]) {
+      level_[vertex] = num_vertices_;
+    }
+    bucket_head_[above] = kNoVertex;
+  }
+  highest_linked_ = height - 1;
+}
+
+void MaxFlowNetwork::AddActive(Vertex vertex) {
+  size_t height = level_[vertex];
+  if (height < num_vertices_) {
+    active_[height].push_back(vertex);
+    highest_active_ = std::max(highest_active_, height);
+  }
+}
+
+void MaxFlowNetwork::Link(Vertex vertex) {
+  size_t height = level_[vertex];
+  bucket_prev_[vertex] = kNoVertex;
+  bucket_next_[vertex] = bucket_head_[height];
+  if (bucket_head_[height] != kNoVertex) {
+    bucket_prev_[bucket_head_[height]] = vertex;
+  }
+  bucket_head_[height] = vertex;
+  highest_linked_ = std::max(highest_linked_, height);
+}
+
+void MaxFlowNetwork::Unlink(Vertex vertex) {
+  Vertex prev = bucket_prev_[vertex];
+  Vertex next = bucket_next_[vertex];
+  if (prev != kNoVertex) {
+    bucket_next_[prev] = next;
+  } else {
+    bucket_head_[level_[vertex]] = next;
+  }
+  if (next != kNoVertex) {
+    bucket_prev_[next] = prev;
+  }
+}
+
+void MaxFlowNetwork::ReturnExcess(Vertex source, Vertex sink) {
+  // Heights are now residual distances to the source; the sink is left
+  // alone, as no excess can reach it
+  level_.assign(num_vertices_, kNoLevel);
+  level_[source] = 0;
+  queue_.assign(1, source);
+  for (size_t head = 0; head < queue_.size(); ++head) {
+    Vertex vertex = queue_[head];
+    for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+      Vertex prev = heads_[arc];
+      if (prev != sink && level_[prev] == kNoLevel &&
+          residual_[reverse_[arc]] > 0) {
+        level_[prev] = level_[vertex] + 1;
+        queue_.push_back(prev);
+      }
+    }
+  }
+
+  queue_.clear();
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    if (vertex != source && vertex != sink && excess_[vertex] > 0) {
+      queue_.push_back(vertex);
+    }
+  }
+  current_.assign(offsets_.begin(), offsets_.end() - 1);
+  for (size_t head = 0; head < queue_.size(); ++head) {
+    Vertex vertex = queue_[head];
+    while (excess_[vertex] > 0) {
+      if (current_[vertex] == ArcsEnd(vertex)) {
+        size_t lowest = kNoLevel;
+        for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+          Vertex next = heads_[arc];
+          if (residual_[arc] > 0 && next != sink && level_[next] != kNoLevel) {
+            lowest = std::min(lowest, level_[next] + 1);
+          }
+        }
+        assert(lowest != kNoLevel);
+        level_[vertex] = lowest;
+        current_[vertex] = ArcsBegin(vertex);
+        continue;
+      }
+      size_t arc = current_[vertex];
+      Vertex next = heads_[arc];
+      if (residual_[arc] > 0 && next != sink && level_[next] != kNoLevel &&
+          level_[vertex] == level_[next] + 1) {
+        Capacity amount = std::min(excess_[vertex], residual_[arc]);
+        if (excess_[next] == 0 && next != source) {
+          queue_.push_back(next);
+        }
+        Push(arc, amount);
+        excess_[vertex] -= amount;
+        excess_[next] += amount;
+      } else {
+        ++current_[vertex];
+      }
+    }
+  }
+}
@@ -0,0 +1,143 @@
+#ifndef FLOW_MAX_FLOW_H
+#define FLOW_MAX_FLOW_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "../graphs/IGraph.h"
+
+using Capacity = int64_t;
+
+enum class MaxFlowAlgorithm { Dinic, PushRelabel };
+
+struct CapacityUpdate {
+  size_t edge;
+  Capacity capacity;
+};
+
+// Flow network with the residual graph kept as an edge array: every edge
+// becomes an arc and a paired reverse arc, and the arcs are laid out in CSR
+// order by tail, so a vertex's residual arcs are one contiguous run and
+// memory is O(V + E).
+//
+// After FindMaxFlow the residual network stays alive: UpdateCapacities
+// changes a batch of capacities and brings the flow back to a maximum from
+// where it was, rather than from zero.
+class MaxFlowNetwork {
+ public:
+  explicit MaxFlowNetwork(size_t num_vertices);
+
+  size_t VerticesCount() const { return num_vertices_; }
+
+  size_t EdgesCount() const { return edge_tails_.size(); }
+
+  // Returns the edge's index; parallel and antiparallel edges are fine
+  size_t AddEdge(Vertex from, Vertex to, Capacity capacity);
+
+  // Starts from zero flow each time
+  Capacity FindMaxFlow(Vertex source, Vertex sink,
+                       MaxFlowAlgorithm algorithm = MaxFlowAlgorithm::Dinic);
+
+  // Sets the capacities of some edges and returns the new maximum flow
+  // between the last FindMaxFlow's source and sink. Overflow on lowered
+  // edges is first rerouted around them, and whatever cannot be is sent on
+  // to the sink or cancelled back to the source; Dinic then augments from
+  // the repaired flow, through the raised edges among others.
+  Capacity UpdateCapacities(const std::vector<CapacityUpdate>& updates);
+
+  Capacity EdgeCapacity(size_t edge) const { return edge_capacities_[edge]; }
+
+  // Flow along an edge after FindMaxFlow
+  Capacity Flow(size_t edge) const;
+
+  // Value of the current flow
+  Capacity FlowValue() const { return flow_value_; }
+
+  // Vertices reachable from the source in the residual network: the
+  // source side of a minimum cut
+  std::vector<bool> MinCutSide() const;
+
+  // Edges from the source side to the rest, whose capacities add up to
+  // FlowValue()
+  std::vector<size_t> MinCutEdges() const;
+
+ private:
+  static constexpr size_t kNoLevel = std::numeric_limits<size_t>::max();
+
+  void Build();
+
+  size_t ArcsBegin(Vertex vertex) const { return offsets_[vertex]; }
+
+  size_t ArcsEnd(Vertex vertex) const { return offsets_[vertex + 1]; }
+
+  void Push(size_t arc, Capacity amount) {
+    residual_[arc] -= amount;
+    residual_[reverse_[arc]] += amount;
+  }
+
+  // Dinic: BFS levels from the source over residual arcs, then blocking
+  // flows along level-increasing arcs; current_ remembers the first arc
+  // of each vertex that may still carry flow in this phase
+  Capacity Dinic(Vertex source, Vertex sink);
+  bool BuildLevels(Vertex source, Vertex sink);
+  Capacity BlockingFlow(Vertex source, Vertex sink);
+
+  // Highest-label push-relabel with the gap heuristic and periodic global
+  // relabeling. The first phase finds a maximum preflow, the second returns
+  // the excess stuck in vertices that cannot reach the sink to the source.
+  Capacity PushRelabel(Vertex source, Vertex sink);
+  void GlobalRelabel(Vertex source, Vertex sink);
+  void Discharge(Vertex vertex, Vertex source, Vertex sink);
+  void Relabel(Vertex vertex);
+  void Gap(size_t height);
+  void AddActive(Vertex vertex);
+  void Link(Vertex vertex);
+  void Unlink(Vertex vertex);
+  void ReturnExcess(Vertex source, Vertex sink);
+
+  // Augments along residual paths from `from` to `to`, either of which
+  // may be kNoVertex for "any vertex with a surplus" or "any vertex with a
+  // shortage" (nonzero excess_ other than at the source and the sink),
+  // until one side is used up or nothing connects them
+  void Reroute(Vertex from, Vertex to);
+
+  Capacity NetOutflow(Vertex vertex) const;
+
+  size_t num_vertices_;
+  std::vector<Vertex> edge_tails_;
+  std::vector<Vertex> edge_heads_;
+  std::vector<Capacity> edge_capacities_;
+  bool built_ = false;
+  bool solved_ = false;
+  Vertex source_ = 0;
+  Vertex sink_ = 0;
+  Capacity flow_value_ = 0;
+
+  // Residual arcs; edge_arcs_[e] is the forward arc of edge e
+  std::vector<size_t> offsets_;
+  std::vector<Vertex> heads_;
+  std::vector<size_t> reverse_;
+  std::vector<Capacity> capacities_;
+  std::vector<Capacity> residual_;
+  std::vector<size_t> edge_arcs_;
+
+  // Shared by both algorithms
+  std::vector<size_t> current_;
+  std::vector<size_t> level_;  // Dinic levels, push-relabel heights
+  std::vector<size_t> path_;
+  std::vector<Vertex> queue_;
+
+  // Push-relabel: excess, active vertices per height (may hold stale
+  // entries), and every vertex below height n in a doubly linked list per
+  // height, for the gap heuristic
+  std::vector<Capacity> excess_;
+  std::vector<std::vector<Vertex>> active_;
+  size_t highest_active_ = 0;
+  std::vector<Vertex> bucket_head_;
+  std::vector<Vertex> bucket_next_;
+  std::vector<Vertex> bucket_prev_;
+  size_t highest_linked_ = 0;
+  size_t relabels_since_global_ = 0;
+};
+
+#endif  // FLOW_MAX_FLOW_H
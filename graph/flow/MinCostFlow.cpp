@@ -0,0 +1,294 @@
+#include "MinCostFlow.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include "../shortest path/ford-bellman/BellmanFord.h"
+
+namespace {
+
+const Cost kInfiniteCost = std::numeric_limits<Cost>::max();
+const size_t kNoArc = std::numeric_limits<size_t>::max();
+
+// Epsilon shrinks by this factor between refinements
+const Cost kScalingFactor = 8;
+
+}  // namespace
+
+MinCostFlowNetwork::MinCostFlowNetwork(size_t num_vertices)
+    : num_vertices_(num_vertices), heap_(num_vertices) {}
+
+size_t MinCostFlowNetwork::AddEdge(Vertex from, Vertex to, Capacity capacity,
+                                   Cost cost) {
+  assert(from < VerticesCount() && to < VerticesCount());
+  assert(capacity >= 0);
+  edge_tails_.push_back(from);
+  edge_heads_.push_back(to);
+  edge_capacities_.push_back(capacity);
+  edge_costs_.push_back(cost);
+  built_ = false;
+  return EdgesCount() - 1;
+}
+
+void MinCostFlowNetwork::Build() {
+  offsets_.assign(num_vertices_ + 1, 0);
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    ++offsets_[edge_tails_[edge] + 1];
+    ++offsets_[edge_heads_[edge] + 1];
+  }
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    offsets_[vertex + 1] += offsets_[vertex];
+  }
+  size_t num_arcs = offsets_.back();
+  tails_.resize(num_arcs);
+  heads_.resize(num_arcs);
+  reverse_.resize(num_arcs);
+  capacities_.resize(num_arcs);
+  costs_.resize(num_arcs);
+  edge_arcs_.resize(EdgesCount());
+  auto position = std::vector<size_t>(offsets_.begin(), offsets_.end() - 1);
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    Vertex from = edge_tails_[edge];
+    Vertex to = edge_heads_[edge];
+    size_t forward = position[from]++;
+    size_t backward = position[to]++;
+    tails_[forward] = from;
+    heads_[forward] = to;
+    tails_[backward] = to;
+    heads_[backward] = from;
+    reverse_[forward] = backward;
+    reverse_[backward] = forward;
+    capacities_[forward] = edge_capacities_[edge];
+    capacities_[backward] = 0;
+    costs_[forward] = edge_costs_[edge];
+    costs_[backward] = -edge_costs_[edge];
+    edge_arcs_[edge] = forward;
+  }
+  distance_.assign(num_vertices_, kInfiniteCost);
+  parent_arc_.assign(num_vertices_, kNoArc);
+  touched_.clear();
+  built_ = true;
+}
+
+MinCostFlowResult MinCostFlowNetwork::FindMinCostFlow(
+    Vertex source, Vertex sink, Capacity limit,
+    MinCostFlowAlgorithm algorithm) {
+  assert(source < VerticesCount() && sink < VerticesCount());
+  assert(limit >= 0);
+  if (!built_) {
+    Build();
+  }
+  residual_ = capacities_;
+  if (source == sink) {
+    return MinCostFlowResult();
+  }
+  switch (algorithm) {
+    case MinCostFlowAlgorithm::SuccessiveShortestPaths:
+      return SuccessiveShortestPaths(source, sink, limit);
+    case MinCostFlowAlgorithm::CostScaling:
+      return CostScaling(source, sink, limit);
+    default:
+      assert(false);
+      return MinCostFlowResult();
+  }
+}
+
+Capacity MinCostFlowNetwork::Flow(size_t edge) const {
+  assert(built_ && edge < EdgesCount());
+  size_t arc = edge_arcs_[edge];
+  return capacities_[arc] - residual_[arc];
+}
+
+MinCostFlowResult MinCostFlowNetwork::SuccessiveShortestPaths(
+    Vertex source, Vertex sink, Capacity limit) {
+  MinCostFlowResult result;
+  InitPotentials(source);
+  while (result.flow < limit && FindShortestPath(source, sink)) {
+    Capacity amount = limit - result.flow;
+    Cost path_cost = 0;
+    for (Vertex vertex = sink; vertex != source;
+         vertex = tails_[parent_arc_[vertex]]) {
+      amount = std::min(amount, residual_[parent_arc_[vertex]]);
+      path_cost += costs_[parent_arc_[vertex]];
+    }
+    for (Vertex vertex = sink; vertex != source;
+         vertex = tails_[parent_arc_[vertex]]) {
+      Push(parent_arc_[vertex], amount);
+    }
+    result.flow += amount;
+    result.cost += amount * path_cost;
+  }
+  return result;
+}
+
+void MinCostFlowNetwork::InitPotentials(Vertex source) {
+  potential_.assign(num_vertices_, 0);
+  bool has_negative = false;
+  for (size_t arc = 0; arc < residual_.size(); ++arc) {
+    has_negative |= residual_[arc] > 0 && costs_[arc] < 0;
+  }
+  if (!has_negative) {
+    return;
+  }
+  // Distances from the source; vertices it cannot reach never take part
+  std::vector<WeightedEdge<Cost>> edges;
+  for (size_t arc = 0; arc < residual_.size(); ++arc) {
+    if (residual_[arc] > 0) {
+      edges.push_back({tails_[arc], heads_[arc], costs_[arc]});
+    }
+  }
+  auto distances = BellmanFord<Cost>(num_vertices_, edges).Run(source);
+  assert(!distances.HasNegativeCycle());
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    if (distances.distance[vertex] !=
+        BellmanFordResult<Cost>::kUnreached) {
+      potential_[vertex] = distances.distance[vertex];
+    }
+  }
+}
+
+bool MinCostFlowNetwork::FindShortestPath(Vertex source, Vertex sink) {
+  for (auto vertex : touched_) {
+    distance_[vertex] = kInfiniteCost;
+    parent_arc_[vertex] = kNoArc;
+  }
+  touched_.clear();
+  heap_.Clear();
+  distance_[source] = 0;
+  touched_.push_back(source);
+  heap_.Update(source, 0);
+  while (!heap_.Empty()) {
+    auto [vertex, distance] = heap_.Pop();
+    if (vertex == sink) {
+      break;
+    }
+    for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+      if (residual_[arc] == 0) {
+        continue;
+      }
+      Vertex next = heads_[arc];
+      Cost candidate = distance + ReducedCost(arc);
+      if (candidate < distance_[next]) {
+        if (distance_[next] == kInfiniteCost) {
+          touched_.push_back(next);
+        }
+        distance_[next] = candidate;
+        parent_arc_[next] = arc;
+        heap_.Update(next, candidate);
+      }
+    }
+  }
+  Cost sink_distance = distance_[sink];
+  if (sink_distance == kInfiniteCost) {
+    return false;
+  }
+  // p += min(d, d(sink)) keeps reduced costs non-negative; shifting every
+  // potential by -d(sink) changes none of them, and leaves only the vertices
+  // settled before the sink to update
+  for (auto vertex : touched_) {
+    if (distance_[vertex] < sink_distance) {
+      potential_[vertex] -= sink_distance - distance_[vertex];
+    }
+  }
+  return true;
+}
+
+MinCostFlowResult MinCostFlowNetwork::CostScaling(Vertex source, Vertex sink,
+                                                  Capacity limit) {
+  // Start from a maximum flow; cancelling cycles keeps its value
+  MaxFlowNetwork network(num_vertices_ + 1);
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    network.AddEdge(edge_tails_[edge], edge_heads_[edge],
+                    edge_capacities_[edge]);
+  }
+  MinCostFlowResult result;
+  if (limit == kNoLimit) {
+    result.flow = network.FindMaxFlow(source, sink);
+  } else {
+    // Through an extra vertex feeding the source at most limit
+    network.AddEdge(num_vertices_, source, limit);
+    result.flow = network.FindMaxFlow(num_vertices_, sink);
+  }
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    Push(edge_arcs_[edge], network.Flow(edge));
+  }
+
+  // With costs scaled by V + 1, a 1-optimal flow is optimal
+  Cost scale = num_vertices_ + 1;
+  Cost epsilon = 0;
+  for (auto& cost : costs_) {
+    cost *= scale;
+    epsilon = std::max(epsilon, std::abs(cost));
+  }
+  potential_.assign(num_vertices_, 0);
+  while (epsilon > 1) {
+    epsilon = std::max<Cost>(1, epsilon / kScalingFactor);
+    Refine(epsilon);
+  }
+  for (auto& cost : costs_) {
+    cost /= scale;
+  }
+
+  for (size_t edge = 0; edge < EdgesCount(); ++edge) {
+    result.cost += Flow(edge) * edge_costs_[edge];
+  }
+  return result;
+}
+
+void MinCostFlowNetwork::Refine(Cost epsilon) {
+  // Saturating every arc of negative reduced cost makes the flow 0-optimal
+  // but unbalanced; pushes along such arcs and relabels then restore the
+  // balance without losing epsilon-optimality
+  excess_.assign(num_vertices_, 0);
+  for (size_t arc = 0; arc < residual_.size(); ++arc) {
+    if (residual_[arc] > 0 && ReducedCost(arc) < 0) {
+      excess_[tails_[arc]] -= residual_[arc];
+      excess_[heads_[arc]] += residual_[arc];
+      Push(arc, residual_[arc]);
+    }
+  }
+  active_.clear();
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    if (excess_[vertex] > 0) {
+      active_.push_back(vertex);
+    }
+  }
+  current_.assign(offsets_.begin(), offsets_.end() - 1);
+
+  for (size_t head = 0; head < active_.size(); ++head) {
+    Vertex vertex = active_[head];
+    while (excess_[vertex] > 0) {
+      if (current_[vertex] == ArcsEnd(vertex)) {
+        // Lower the potential just enough for an arc to turn admissible
+        Cost highest = std::numeric_limits<Cost>::min();
+        for (size_t arc = ArcsBegin(vertex); arc < ArcsEnd(vertex); ++arc) {
+          if (residual_[arc] > 0) {
+            highest =
+                std::max(highest, potential_[heads_[arc]] - costs_[arc]);
+          }
+        }
+        assert(highest != std::numeric_limits<Cost>::min());
+        potential_[vertex] = highest - epsilon;
+        current_[vertex] = ArcsBegin(vertex);
+        continue;
+      }
+      size_t arc = current_[vertex];
+      if (residual_[arc] > 0 && ReducedCost(arc) < 0) {
+        Vertex next = heads_[arc];
+        Capacity amount = std::min(excess_[vertex], residual_[arc]);
+        if (excess_[next] <= 0 && excess_[next] + amount > 0) {
+          active_.push_back(next);
+        }
+        Push(arc, amount);
+        excess_[vertex] -= amount;
+        excess_[next] += amount;
+      } else {
+        ++current_[vertex];
+      }
+    }
+    // Keep the queue from growing without bound
+    if (head + 1 == active_.size() || 2 * head > active_.size() + 1024) {
+      active_.erase(active_.begin(), active_.begin() + head + 1);
+      head = static_cast<size_t>(-1);
+    }
+  }
+}
@@ -0,0 +1,108 @@
+#ifndef FLOW_MIN_COST_FLOW_H
+#define FLOW_MIN_COST_FLOW_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "../graphs/PriorityQueues.h"
+#include "MaxFlow.h"
+
+using Cost = int64_t;
+
+enum class MinCostFlowAlgorithm { SuccessiveShortestPaths, CostScaling };
+
+struct MinCostFlowResult {
+  Capacity flow = 0;
+  Cost cost = 0;
+};
+
+// Min-cost flow over the same residual layout as MaxFlowNetwork: paired
+// arcs in CSR order by tail, each with its cost (the reverse arc has the
+// negated cost).
+//
+// Successive shortest paths keeps Johnson potentials, so every search is a
+// heap-based Dijkstra on non-negative reduced costs; it suits small flow
+// values and needs no negative-cost cycles. Cost scaling (Goldberg-Tarjan)
+// starts from a maximum flow found by MaxFlowNetwork and turns it into a
+// cheapest one by push-relabel refinements with a shrinking epsilon; its
+// running time does not depend on the flow value, so it suits large
+// assignment-like instances, and negative cycles are simply cancelled.
+class MinCostFlowNetwork {
+ public:
+  static constexpr Capacity kNoLimit = std::numeric_limits<Capacity>::max();
+
+  explicit MinCostFlowNetwork(size_t num_vertices);
+
+  size_t VerticesCount() const { return num_vertices_; }
+
+  size_t EdgesCount() const { return edge_tails_.size(); }
+
+  // Returns the edge's index
+  size_t AddEdge(Vertex from, Vertex to, Capacity capacity, Cost cost);
+
+  // The cheapest flow of the largest value up to limit from source to sink
+  MinCostFlowResult FindMinCostFlow(
+      Vertex source, Vertex sink, Capacity limit = kNoLimit,
+      MinCostFlowAlgorithm algorithm =
+          MinCostFlowAlgorithm::SuccessiveShortestPaths);
+
+  // Flow along an edge after FindMinCostFlow
+  Capacity Flow(size_t edge) const;
+
+ private:
+  void Build();
+
+  size_t ArcsBegin(Vertex vertex) const { return offsets_[vertex]; }
+
+  size_t ArcsEnd(Vertex vertex) const { return offsets_[vertex + 1]; }
+
+  void Push(size_t arc, Capacity amount) {
+    residual_[arc] -= amount;
+    residual_[reverse_[arc]] += amount;
+  }
+
+  MinCostFlowResult SuccessiveShortestPaths(Vertex source, Vertex sink,
+                                            Capacity limit);
+  // Potentials making every residual arc's reduced cost non-negative
+  void InitPotentials(Vertex source);
+  // Dijkstra on reduced costs, stopped once the sink is settled; false if
+  // the sink is unreachable
+  bool FindShortestPath(Vertex source, Vertex sink);
+
+  MinCostFlowResult CostScaling(Vertex source, Vertex sink, Capacity limit);
+  // Makes the flow epsilon-optimal for costs scaled by num_vertices_ + 1
+  void Refine(Cost epsilon);
+
+  Cost ReducedCost(size_t arc) const {
+    return costs_[arc] + potential_[tails_[arc]] - potential_[heads_[arc]];
+  }
+
+  size_t num_vertices_;
+  std::vector<Vertex> edge_tails_;
+  std::vector<Vertex> edge_heads_;
+  std::vector<Capacity> edge_capacities_;
+  std::vector<Cost> edge_costs_;
+  bool built_ = false;
+
+  // Residual arcs; edge_arcs_[e] is the forward arc of edge e
+  std::vector<size_t> offsets_;
+  std::vector<Vertex> tails_;
+  std::vector<Vertex> heads_;
+  std::vector<size_t> reverse_;
+  std::vector<Capacity> capacities_;
+  std::vector<Cost> costs_;
+  std::vector<Capacity> residual_;
+  std::vector<size_t> edge_arcs_;
+
+  // Scratch space, kept across augmentations and refinements
+  std::vector<Cost> potential_;
+  std::vector<Cost> distance_;
+  std::vector<size_t> parent_arc_;
+  std::vector<Vertex> touched_;
+  IndexedDaryHeap<Cost> heap_;
+  std::vector<Capacity> excess_;
+  std::vector<size_t> current_;
+  std::vector<Vertex> active_;
+};
+
+#endif  // FLOW_MIN_COST_FLOW_H
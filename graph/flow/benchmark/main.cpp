@@ -0,0 +1,315 @@
+// Times Dinic and push-relabel on the CSR residual graph against the
+// Edmonds-Karp FlowNetwork of edmonds-karp/main.cpp, with its V x V
+// capacity and residual matrices.
+//
+// Usage: benchmark [bipartite_side] [grid_side] [assignment_side]
+//                  [matching_side]
+// Workloads: bipartite matching (bipartite_side vertices on each side,
+// every left vertex joined to 5 random right ones, unit capacities) and a
+// grid cut (grid_side x grid_side, 4-neighbour edges of capacity [1, 100],
+// the left column fed by the source and the right column draining into the
+// sink). On the grid it also times what-if queries: batches of 5 random
+// capacity changes answered by UpdateCapacities against full recomputes.
+// Last, min-cost flow: an assignment of assignment_side workers to as many
+// jobs (10 random jobs per worker, costs in [0, 1000]) solved by successive
+// shortest paths and by cost scaling. Then a large bipartite matching
+// (matching_side vertices on each side, 5 random edges each) by Dinic
+// against Hopcroft-Karp, with and without a greedy start.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../../graphs/BipartiteMatching.h"
+#include "../../graphs/BreadthFirstSearch.h"
+#include "../../graphs/GraphBuilder.h"
+#include "../../graphs/ListGraph.h"
+#include "../MaxFlow.h"
+#include "../MinCostFlow.h"
+
+using FlowType = int;
+
+// The Edmonds-Karp network, kept as the baseline (summing parallel edges,
+// which the random matching can produce)
+class FlowNetwork {
+ public:
+  explicit FlowNetwork(const size_t num_vertices)
+      : support_(num_vertices),
+        capacity_(num_vertices, std::vector<FlowType>(num_vertices, 0)) {}
+
+  void AddEdge(Vertex from, Vertex to, FlowType maxflow) {
+    if (capacity_[from][to] == 0 && capacity_[to][from] == 0) {
+      support_.AddEdge(from, to);
+      support_.AddEdge(to, from);
+    }
+    capacity_[from][to] += maxflow;
+  }
+
+  size_t FindMaxFlow(Vertex from, Vertex to) const {
+    residue_network_ = capacity_;
+    size_t max_flow = 0;
+    std::vector<Vertex> parents;
+    while (ShortestPathInResidualNetworkExists(from, to, parents)) {
+      FlowType min_capacity = residue_network_[parents[to]][to];
+      for (Vertex current = to; current != from; current = parents[current]) {
+        min_capacity = std::min(min_capacity,
+                                residue_network_[parents[current]][current]);
+      }
+      for (Vertex current = to; current != from; current = parents[current]) {
+        residue_network_[parents[current]][current] -= min_capacity;
+        residue_network_[current][parents[current]] += min_capacity;
+      }
+      max_flow += min_capacity;
+    }
+    return max_flow;
+  }
+
+ private:
+  bool ShortestPathInResidualNetworkExists(
+      Vertex from, Vertex to, std::vector<Vertex>& parents) const {
+    BFSOptions options;
+    options.target = to;
+    options.edge_filter = [this](Vertex current, Vertex next) {
+      return residue_network_[current][next] != 0;
+    };
+    auto bfs = BreadthFirstSearch(support_, options).Run(from);
+    parents = std::move(bfs.parents);
+    return bfs.levels[to] != kUnreached;
+  }
+
+  ListGraph support_;
+  std::vector<std::vector<FlowType>> capacity_;
+  mutable std::vector<std::vector<FlowType>> residue_network_;
+};
+
+struct Workload {
+  std::string name;
+  size_t num_vertices;
+  std::vector<std::tuple<Vertex, Vertex, FlowType>> edges;
+  Vertex source;
+  Vertex sink;
+};
+
+Workload BipartiteMatching(size_t side, std::mt19937_64& generator) {
+  Workload workload{"bipartite matching", 2 * side + 2, {}, 2 * side,
+                    2 * side + 1};
+  std::uniform_int_distribution<Vertex> right(side, 2 * side - 1);
+  for (Vertex left = 0; left < side; ++left) {
+    workload.edges.emplace_back(workload.source, left, 1);
+    for (int i = 0; i < 5; ++i) {
+      workload.edges.emplace_back(left, right(generator), 1);
+    }
+  }
+  for (Vertex vertex = side; vertex < 2 * side; ++vertex) {
+    workload.edges.emplace_back(vertex, workload.sink, 1);
+  }
+  return workload;
+}
+
+Workload GridCut(size_t side, std::mt19937_64& generator) {
+  Workload workload{"grid cut", side * side + 2, {}, side * side,
+                    side * side + 1};
+  std::uniform_int_distribution<FlowType> capacity(1, 100);
+  for (Vertex row = 0; row < side; ++row) {
+    for (Vertex column = 0; column < side; ++column) {
+      Vertex vertex = row * side + column;
+      if (column + 1 < side) {
+        workload.edges.emplace_back(vertex, vertex + 1, capacity(generator));
+        workload.edges.emplace_back(vertex + 1, vertex, capacity(generator));
+      }
+      if (row + 1 < side) {
+        workload.edges.emplace_back(vertex, vertex + side, capacity(generator));
+        workload.edges.emplace_back(vertex + side, vertex, capacity(generator));
+      }
+    }
+    workload.edges.emplace_back(workload.source, row * side, 1000);
+    workload.edges.emplace_back(row * side + side - 1, workload.sink, 1000);
+  }
+  return workload;
+}
+
+template <typename Function>
+double Measure(const std::string& name, Function function,
+               const std::string& what = "flow") {
+  auto start = std::chrono::steady_clock::now();
+  auto flow = function();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  std::cout << "  " << name << ": " << seconds << " s, " << what << " "
+            << flow << std::endl;
+  return seconds;
+}
+
+bool Run(const Workload& workload) {
+  std::cout << workload.name << ": " << workload.num_vertices
+            << " vertices, " << workload.edges.size() << " edges"
+            << std::endl;
+  FlowNetwork baseline(workload.num_vertices);
+  MaxFlowNetwork network(workload.num_vertices);
+  for (auto [from, to, capacity] : workload.edges) {
+    baseline.AddEdge(from, to, capacity);
+    network.AddEdge(from, to, capacity);
+  }
+  Capacity expected = 0;
+  Capacity dinic = 0;
+  Capacity push_relabel = 0;
+  double edmonds_karp = Measure("Edmonds-Karp", [&] {
+    return expected = baseline.FindMaxFlow(workload.source, workload.sink);
+  });
+  double seconds = Measure("Dinic", [&] {
+    return dinic = network.FindMaxFlow(workload.source, workload.sink,
+                                       MaxFlowAlgorithm::Dinic);
+  });
+  std::cout << "    speedup x" << edmonds_karp / seconds << std::endl;
+  seconds = Measure("push-relabel", [&] {
+    return push_relabel = network.FindMaxFlow(
+               workload.source, workload.sink, MaxFlowAlgorithm::PushRelabel);
+  });
+  std::cout << "    speedup x" << edmonds_karp / seconds << std::endl;
+  return dinic == expected && push_relabel == expected;
+}
+
+bool RunUpdates(const Workload& workload, std::mt19937_64& generator) {
+  const int kBatches = 200;
+  const int kBatchSize = 5;
+  MaxFlowNetwork incremental(workload.num_vertices);
+  std::vector<Capacity> capacities;
+  for (auto [from, to, capacity] : workload.edges) {
+    incremental.AddEdge(from, to, capacity);
+    capacities.push_back(capacity);
+  }
+  incremental.FindMaxFlow(workload.source, workload.sink);
+  std::uniform_int_distribution<size_t> edge(0, workload.edges.size() - 1);
+  std::uniform_int_distribution<Capacity> capacity(0, 150);
+  std::vector<std::vector<CapacityUpdate>> batches(kBatches);
+  for (auto& batch : batches) {
+    for (int i = 0; i < kBatchSize; ++i) {
+      batch.push_back({edge(generator), capacity(generator)});
+    }
+  }
+
+  std::cout << workload.name << ", " << kBatches << " batches of "
+            << kBatchSize << " capacity changes" << std::endl;
+  std::vector<Capacity> updated;
+  std::vector<Capacity> expected;
+  double incremental_seconds = Measure("UpdateCapacities", [&] {
+    for (const auto& batch : batches) {
+      updated.push_back(incremental.UpdateCapacities(batch));
+    }
+    return updated.back();
+  });
+  double recomputed_seconds = Measure("FindMaxFlow from scratch", [&] {
+    for (const auto& batch : batches) {
+      for (const auto& update : batch) {
+        capacities[update.edge] = update.capacity;
+      }
+      MaxFlowNetwork network(workload.num_vertices);
+      for (size_t i = 0; i < workload.edges.size(); ++i) {
+        network.AddEdge(std::get<0>(workload.edges[i]),
+                        std::get<1>(workload.edges[i]), capacities[i]);
+      }
+      expected.push_back(network.FindMaxFlow(workload.source, workload.sink));
+    }
+    return expected.back();
+  });
+  std::cout << "    speedup x" << recomputed_seconds / incremental_seconds
+            << std::endl;
+  return updated == expected;
+}
+
+bool RunAssignment(size_t side, std::mt19937_64& generator) {
+  const int kJobsPerWorker = 10;
+  Vertex source = 2 * side;
+  Vertex sink = 2 * side + 1;
+  MinCostFlowNetwork network(2 * side + 2);
+  std::uniform_int_distribution<Vertex> job(side, 2 * side - 1);
+  std::uniform_int_distribution<Cost> cost(0, 1000);
+  for (Vertex worker = 0; worker < side; ++worker) {
+    network.AddEdge(source, worker, 1, 0);
+    network.AddEdge(side + worker, sink, 1, 0);
+    for (int i = 0; i < kJobsPerWorker; ++i) {
+      network.AddEdge(worker, job(generator), 1, cost(generator));
+    }
+  }
+
+  std::cout << "assignment: " << side << " workers, " << network.EdgesCount()
+            << " edges" << std::endl;
+  MinCostFlowResult paths;
+  MinCostFlowResult scaling;
+  auto successive_shortest_paths = [&] {
+    paths = network.FindMinCostFlow(source, sink);
+    return paths.cost;
+  };
+  auto cost_scaling = [&] {
+    scaling = network.FindMinCostFlow(source, sink,
+                                      MinCostFlowNetwork::kNoLimit,
+                                      MinCostFlowAlgorithm::CostScaling);
+    return scaling.cost;
+  };
+  double seconds =
+      Measure("successive shortest paths", successive_shortest_paths, "cost");
+  seconds /= Measure("cost scaling", cost_scaling, "cost");
+  std::cout << "    speedup x" << seconds << std::endl;
+  return paths.flow == scaling.flow && paths.cost == scaling.cost;
+}
+
+bool RunMatching(size_t side, std::mt19937_64& generator) {
+  auto workload = BipartiteMatching(side, generator);
+  MaxFlowNetwork network(workload.num_vertices);
+  GraphBuilder builder(2 * side);
+  for (auto [from, to, capacity] : workload.edges) {
+    network.AddEdge(from, to, capacity);
+    if (from < 2 * side && to < 2 * side) {
+      builder.AddEdge(from, to);
+      builder.AddEdge(to, from);
+    }
+  }
+  auto graph = builder.BuildCSRGraph();
+
+  std::cout << "matching: " << 2 * side << " vertices, "
+            << graph.EdgesCount() / 2 << " edges" << std::endl;
+  Capacity expected = 0;
+  size_t plain = 0;
+  size_t greedy = 0;
+  double dinic = Measure("Dinic", [&] {
+    return expected = network.FindMaxFlow(workload.source, workload.sink);
+  });
+  double seconds = Measure("Hopcroft-Karp", [&] {
+    auto bipartition = FindBipartition(graph);
+    return plain = FindMaximumMatching(graph, bipartition.side).size;
+  }, "matching");
+  std::cout << "    speedup x" << dinic / seconds << std::endl;
+  seconds = Measure("Hopcroft-Karp, greedy start", [&] {
+    auto bipartition = FindBipartition(graph);
+    MatchingOptions options;
+    options.greedy_start = true;
+    return greedy = FindMaximumMatching(graph, bipartition.side, options).size;
+  }, "matching");
+  std::cout << "    speedup x" << dinic / seconds << std::endl;
+  return plain == static_cast<size_t>(expected) &&
+         greedy == static_cast<size_t>(expected);
+}
+
+int main(int argc, char** argv) {
+  size_t bipartite_side =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+  size_t grid_side = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+  size_t assignment_side =
+      argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000;
+  size_t matching_side =
+      argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 200000;
+
+  std::mt19937_64 generator(42);
+  bool ok = Run(BipartiteMatching(bipartite_side, generator));
+  auto grid = GridCut(grid_side, generator);
+  ok = Run(grid) && ok;
+  ok = RunUpdates(grid, generator) && ok;
+  ok = RunAssignment(assignment_side, generator) && ok;
+  ok = RunMatching(matching_side, generator) && ok;
+  std::cout << (ok ? "results agree" : "results differ") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -1,60 +1,49 @@
 #include <cassert>
 #include <iostream>
-#include <queue>
-#include <unordered_map>
 #include <vector>
+#include "../../graphs/BreadthFirstSearch.h"
+#include "../../graphs/ListGraph.h"
 
-using Vertex = int;
 using FlowType = int;
 
-class ListGraph {
+class FlowNetwork {
  public:
-  explicit ListGraph(const size_t num_vertices)
-      : next_vertices_(num_vertices, std::vector<Vertex>()),
-        prev_vertives_(num_vertices, std::vector<Vertex>()),
+  explicit FlowNetwork(const size_t num_vertices)
+      : support_(num_vertices),
         capacity_(num_vertices, std::vector<FlowType>(num_vertices, 0)) {}
 
   void AddEdge(Vertex from, Vertex to, FlowType maxflow);
 
-  size_t VerticesCount() const { return next_vertices_.size(); }
-
-  void GetNextVertices(
-      Vertex vertex, std::vector<std::pair<Vertex, FlowType>>& vertices) const;
+  size_t VerticesCount() const { return capacity_.size(); }
 
   bool ShortestPathInResidualNetworkExists(
-      Vertex from, Vertex to,
-      std::unordered_map<Vertex, Vertex>& parents) const;
+      Vertex from, Vertex to, std::vector<Vertex>& parents) const;
 
   bool FindAugmentingPath(Vertex from, Vertex to, FlowType& path_maxflow) const;
 
   size_t FindMaxFlow(Vertex from, Vertex to) const;
 
  private:
-  std::vector<std::vector<Vertex>> next_vertices_;
-  std::vector<std::vector<Vertex>> prev_vertives_;
+  // Both directions of every capacity edge: the residual network only ever
+  // has arcs along these pairs
+  ListGraph support_;
   mutable std::vector<std::vector<FlowType>> capacity_;
   mutable std::vector<std::vector<FlowType>> residue_network_;
 };
 
-void ListGraph::AddEdge(Vertex from, Vertex to, FlowType maxflow) {
-  assert(0 <= from && from < VerticesCount());
-  assert(0 <= to && to < VerticesCount());
-  capacity_[from][to] = maxflow;
-}
-
-void ListGraph::GetNextVertices(
-    Vertex vertex, std::vector<std::pair<Vertex, FlowType>>& vertices) const {
-  vertices.clear();
-  for (Vertex to = 0; to < VerticesCount(); ++to) {
-    if (residue_network_[vertex][to] != 0) {
-      vertices.emplace_back(to, residue_network_[vertex][to]);
-    }
+void FlowNetwork::AddEdge(Vertex from, Vertex to, FlowType maxflow) {
+  assert(from < VerticesCount());
+  assert(to < VerticesCount());
+  if (capacity_[from][to] == 0 && capacity_[to][from] == 0) {
+    support_.AddEdge(from, to);
+    support_.AddEdge(to, from);
   }
+  capacity_[from][to] = maxflow;
 }
 
-bool ListGraph::FindAugmentingPath(Vertex from, Vertex to,
+bool FlowNetwork::FindAugmentingPath(Vertex from, Vertex to,
                                    FlowType& path_maxflow) const {
-  std::unordered_map<Vertex, Vertex> parents;
+  std::vector<Vertex> parents;
   bool path_exists = ShortestPathInResidualNetworkExists(from, to, parents);
   if (path_exists) {
     Vertex current = to;
@@ -85,7 +74,7 @@ bool ListGraph::FindAugmentingPath(Vertex from, Vertex to,
   return path_exists;
 }
 
-size_t ListGraph::FindMaxFlow(Vertex from, Vertex to) const {
+size_t FlowNetwork::FindMaxFlow(Vertex from, Vertex to) const {
   residue_network_ = capacity_;
   FlowType path_maxflow = 0;
   size_t max_flow = 0;
@@ -95,29 +84,20 @@ size_t ListGraph::FindMaxFlow(Vertex from, Vertex to) const {
   return max_flow;
 }
 
-bool ListGraph::ShortestPathInResidualNetworkExists(
-    Vertex from, Vertex to, std::unordered_map<Vertex, Vertex>& parents) const {
-  std::queue<Vertex> vertices_queue;
-  std::vector<bool> visited(VerticesCount(), false);
-  std::vector<std::pair<Vertex, FlowType>> next_vertices;
-  vertices_queue.push(from);
-  parents[from] = from;
-  while (!vertices_queue.empty()) {
-    Vertex current = vertices_queue.front();
-    vertices_queue.pop();
-    if (current == to) {
-      return true;
-    }
-    GetNextVertices(current, next_vertices);
-    for (auto [next, edge_capacity] : next_vertices) {
-      if (!visited[next] && (edge_capacity != 0)) {
-        vertices_queue.push(next);
-        parents[next] = current;
-        visited[next] = true;
-      }
-    }
-  }
-  return false;
+bool FlowNetwork::ShortestPathInResidualNetworkExists(
+    Vertex from, Vertex to, std::vector<Vertex>& parents) const {
+  // One augmenting path is a small search: threads and direction switching
+  // would cost more than they save
+  BFSOptions options;
+  options.num_threads = 1;
+  options.direction_optimizing = false;
+  options.target = to;
+  options.edge_filter = [this](Vertex current, Vertex next) {
+    return residue_network_[current][next] != 0;
+  };
+  auto bfs = BreadthFirstSearch(support_, options).Run(from);
+  parents = std::move(bfs.parents);
+  return bfs.levels[to] != kUnreached;
 }
 
 int main() {
@@ -125,7 +105,7 @@ int main() {
   size_t num_edges = 0;
   std::cin >> num_vertices;
   std::cin >> num_edges;
-  auto graph = ListGraph(num_vertices);
+  auto graph = FlowNetwork(num_vertices);
   for (size_t i = 0; i < num_edges; ++i) {
     Vertex from = 0;
     Vertex to = 0;
@@ -0,0 +1,26 @@
+#include <iostream>
+#include <string>
+#include "../MaxFlow.h"
+
+// Reads "V E" and E lines "from to capacity" with 1-based vertices, as the
+// edmonds-karp tool does, and prints the maximum flow from vertex 1 to
+// vertex V. Dinic by default, push-relabel with --push-relabel.
+int main(int argc, char** argv) {
+  auto algorithm = MaxFlowAlgorithm::Dinic;
+  if (argc > 1 && std::string(argv[1]) == "--push-relabel") {
+    algorithm = MaxFlowAlgorithm::PushRelabel;
+  }
+  std::ios::sync_with_stdio(false);
+  size_t num_vertices = 0;
+  size_t num_edges = 0;
+  std::cin >> num_vertices >> num_edges;
+  MaxFlowNetwork network(num_vertices);
+  for (size_t i = 0; i < num_edges; ++i) {
+    Vertex from = 0;
+    Vertex to = 0;
+    Capacity capacity = 0;
+    std::cin >> from >> to >> capacity;
+    network.AddEdge(from - 1, to - 1, capacity);
+  }
+  std::cout << network.FindMaxFlow(0, num_vertices - 1, algorithm);
+}
@@ -0,0 +1,31 @@
+#include <iostream>
+#include <string>
+#include "../MinCostFlow.h"
+
+// Reads "V E" and E lines "from to capacity cost" with 1-based vertices and
+// prints the value and the cost of the cheapest maximum flow from vertex 1
+// to vertex V. Successive shortest paths by default, cost scaling with
+// --cost-scaling.
+int main(int argc, char** argv) {
+  auto algorithm = MinCostFlowAlgorithm::SuccessiveShortestPaths;
+  if (argc > 1 && std::string(argv[1]) == "--cost-scaling") {
+    algorithm = MinCostFlowAlgorithm::CostScaling;
+  }
+  std::ios::sync_with_stdio(false);
+  size_t num_vertices = 0;
+  size_t num_edges = 0;
+  std::cin >> num_vertices >> num_edges;
+  MinCostFlowNetwork network(num_vertices);
+  for (size_t i = 0; i < num_edges; ++i) {
+    Vertex from = 0;
+    Vertex to = 0;
+    Capacity capacity = 0;
+    Cost cost = 0;
+    std::cin >> from >> to >> capacity >> cost;
+    network.AddEdge(from - 1, to - 1, capacity, cost);
+  }
+  auto result = network.FindMinCostFlow(0, num_vertices - 1,
+                                        MinCostFlowNetwork::kNoLimit,
+                                        algorithm);
+  std::cout << result.flow << ' ' << result.cost;
+}
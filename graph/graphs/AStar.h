@@ -0,0 +1,272 @@
+#ifndef INC_1_A_ASTAR_H
+#define INC_1_A_ASTAR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct AStarOptions {
+  // Nodes are ordered by g + weight * h. Above 1 this is weighted A*:
+  // fewer expansions, and with an admissible heuristic the path is at most
+  // `weight` times longer than the shortest one.
+  double weight = 1.0;
+  // Order by h alone (greedy best-first search): no bound on the length
+  bool greedy = false;
+};
+
+template <typename Action>
+struct AStarResult {
+  bool found = false;
+  int cost = 0;
+  // From the start state to the goal
+  std::vector<Action> actions;
+  size_t expanded = 0;
+};
+
+// Best-first search over an implicit state space:
+//   successors(state, emit)  calls emit(action, next_state, step_cost) for
+//                            every move out of state
+//   heuristic(state)         estimate of the cost left to a goal
+//   hash(state)              with State's operator== for duplicates
+// Every generated state is stored once, in an arena, with the index of its
+// parent and the action that led to it, so paths are rebuilt only for the
+// answer. Seen states are found through a flat open-addressing table of
+// arena indices.
+template <typename State, typename Action, typename Successors,
+          typename Heuristic, typename Hash = std::hash<State>>
+class AStarEngine {
+ public:
+  using Result = AStarResult<Action>;
+
+  AStarEngine(Successors successors, Heuristic heuristic, Hash hash = Hash())
+      : successors_(successors), heuristic_(heuristic), hash_(hash) {}
+
+  // A* (or weighted A*, or greedy best-first, see AStarOptions) until a
+  // state satisfying is_goal is expanded. Improved states are reopened, so
+  // plain A* stays optimal with an admissible, even inconsistent, heuristic;
+  // greedy search only shortens paths to states not yet expanded.
+  template <typename IsGoal>
+  Result Search(const State& start, IsGoal is_goal,
+                const AStarOptions& options = AStarOptions()) {
+    Result result;
+    nodes_.clear();
+    ClearIndex();
+    Open open;
+    AddNode(start, kNoParent, Action(), 0, HashOf(start));
+    open.emplace(Priority(0, heuristic_(start), options), 0, 0, 0);
+    while (!open.empty()) {
+      auto [priority, tie, entry_g, index] = open.top();
+      open.pop();
+      if (nodes_[index].closed || entry_g != nodes_[index].g) {
+        // Expanded already, or pushed before a cheaper path was found
+        continue;
+      }
+      nodes_[index].closed = true;
+      ++result.expanded;
+      // The arena may grow while successors run
+      State current = nodes_[index].state;
+      int g = nodes_[index].g;
+      if (is_goal(current)) {
+        result.found = true;
+        result.cost = g;
+        result.actions = ActionsTo(index);
+        return result;
+      }
+      successors_(current, [&](const Action& action, const State& next,
+                               int cost) {
+        int next_g = g + cost;
+        uint64_t next_hash = HashOf(next);
+        uint32_t seen = Find(next, next_hash);
+        if (seen == kNoParent) {
+          seen = AddNode(next, index, action, next_g, next_hash);
+        } else if (next_g < nodes_[seen].g &&
+                   !(options.greedy && nodes_[seen].closed)) {
+          nodes_[seen].g = next_g;
+          nodes_[seen].parent = index;
+          nodes_[seen].action = action;
+          nodes_[seen].closed = false;
+        } else {
+          return;
+        }
+        open.emplace(Priority(next_g, heuristic_(next), options),
+                     options.greedy ? next_g : -next_g, next_g, seen);
+      });
+    }
+    return result;
+  }
+
+  // IDA*: depth-first passes bounded by g + h, the bound rising each pass to
+  // the least f that exceeded it. Memory is only the current path, so it
+  // suits problems too large for Search; the heuristic must be admissible.
+  template <typename IsGoal>
+  Result SearchIterativeDeepening(const State& start, IsGoal is_goal) {
+    Result result;
+    std::vector<State> path(1, start);
+    std::vector<Action> actions;
+    int bound = heuristic_(start);
+    while (true) {
+      int next_bound = kNoBound;
+      if (Deepen(path, actions, 0, bound, is_goal, next_bound, result)) {
+        result.found = true;
+        result.actions = actions;
+        return result;
+      }
+      if (next_bound == kNoBound) {
+        return result;
+      }
+      bound = next_bound;
+    }
+  }
+
+  // Distinct states generated by the last Search
+  size_t GeneratedCount() const { return nodes_.size(); }
+
+ private:
+  static constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+  static constexpr int kNoBound = std::numeric_limits<int>::max();
+
+  struct Node {
+    State state;
+    uint32_t parent;
+    Action action;
+    int g;
+    bool closed;
+  };
+
+  // (priority, tie, g, node): least priority first; on ties A* takes the
+  // deeper node (closer to a goal), greedy search the shallower one (keeps
+  // its paths short)
+  using Entry = std::tuple<double, int, int, uint32_t>;
+  using Open =
+      std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+
+  static double Priority(int g, int h, const AStarOptions& options) {
+    return options.greedy ? h : g + options.weight * h;
+  }
+
+  // Spreads the bits of hash_, since identity hashes are common for
+  // integer states and the table uses the low bits
+  uint64_t HashOf(const State& state) const {
+    return static_cast<uint64_t>(hash_(state)) * 0x9E3779B97F4A7C15ULL;
+  }
+
+  uint32_t AddNode(const State& state, uint32_t parent, const Action& action,
+                   int g, uint64_t hash) {
+    auto index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{state, parent, action, g, false});
+    if (2 * (nodes_.size() + 1) > slots_.size()) {
+      Rehash(std::max<size_t>(16, 2 * slots_.size()));
+    }
+    Insert(index, hash);
+    return index;
+  }
+
+  void ClearIndex() {
+    slots_.clear();
+    hashes_.clear();
+  }
+
+  uint32_t Find(const State& state, uint64_t hash) const {
+    if (slots_.empty()) {
+      return kNoParent;
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = (hash >> 32) & mask; slots_[slot] != kNoParent;
+         slot = (slot + 1) & mask) {
+      if (hashes_[slot] == hash && nodes_[slots_[slot]].state == state) {
+        return slots_[slot];
+      }
+    }
+    return kNoParent;
+  }
+
+  void Insert(uint32_t index, uint64_t hash) {
+    size_t mask = slots_.size() - 1;
+    size_t slot = (hash >> 32) & mask;
+    while (slots_[slot] != kNoParent) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = index;
+    hashes_[slot] = hash;
+  }
+
+  void Rehash(size_t capacity) {
+    auto slots = std::move(slots_);
+    auto hashes = std::move(hashes_);
+    slots_.assign(capacity, kNoParent);
+    hashes_.assign(capacity, 0);
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+      if (slots[slot] != kNoParent) {
+        Insert(slots[slot], hashes[slot]);
+      }
+    }
+  }
+
+  std::vector<Action> ActionsTo(uint32_t index) const {
+    std::vector<Action> actions;
+    for (; nodes_[index].parent != kNoParent; index = nodes_[index].parent) {
+      actions.push_back(nodes_[index].action);
+    }
+    return std::vector<Action>(actions.rbegin(), actions.rend());
+  }
+
+  // One IDA* pass below path.back(); leaves the solution in path/actions
+  template <typename IsGoal>
+  bool Deepen(std::vector<State>& path, std::vector<Action>& actions, int g,
+              int bound, IsGoal& is_goal, int& next_bound, Result& result) {
+    State current = path.back();
+    int f = g + heuristic_(current);
+    if (f > bound) {
+      next_bound = std::min(next_bound, f);
+      return false;
+    }
+    ++result.expanded;
+    if (is_goal(current)) {
+      result.cost = g;
+      return true;
+    }
+    bool found = false;
+    successors_(current, [&](const Action& action, const State& next,
+                             int cost) {
+      // Skip moves straight back to the previous state
+      if (found || (path.size() > 1 && next == path[path.size() - 2])) {
+        return;
+      }
+      path.push_back(next);
+      actions.push_back(action);
+      found = Deepen(path, actions, g + cost, bound, is_goal, next_bound,
+                     result);
+      if (!found) {
+        path.pop_back();
+        actions.pop_back();
+      }
+    });
+    return found;
+  }
+
+  Successors successors_;
+  Heuristic heuristic_;
+  Hash hash_;
+  std::vector<Node> nodes_;
+  // Open addressing with linear probing over arena indices; the hashes are
+  // kept to skip most state comparisons and to rehash without hash_
+  std::vector<uint32_t> slots_;
+  std::vector<uint64_t> hashes_;
+};
+
+// Lets the functor types be deduced:
+//   auto engine = MakeAStarEngine<Board, Move>(successors, heuristic);
+template <typename State, typename Action, typename Hash = std::hash<State>,
+          typename Successors, typename Heuristic>
+AStarEngine<State, Action, Successors, Heuristic, Hash> MakeAStarEngine(
+    Successors successors, Heuristic heuristic, Hash hash = Hash()) {
+  return AStarEngine<State, Action, Successors, Heuristic, Hash>(
+      successors, heuristic, hash);
+}
+
+#endif  // INC_1_A_ASTAR_H
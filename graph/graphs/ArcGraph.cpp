@@ -3,13 +3,12 @@
 //
 
 #include "ArcGraph.h"
+#include <algorithm>
 
-ArcGraph::ArcGraph(const IGraph* graph) {
+ArcGraph::ArcGraph(const IGraph* graph) : indexed_edges_(0) {
   num_vertices_ = graph->VerticesCount();
   for (size_t from = 0; from < num_vertices_; ++from) {
-    auto temp = std::vector<Vertex>();
-    graph->GetNextVertices(from, temp);
-    for (auto to : temp) {
+    for (auto to : graph->NextVertices(from)) {
       edges_.emplace_back(std::make_pair(from, to));
     }
   }
@@ -19,22 +18,75 @@ void ArcGraph::AddEdge(Vertex from, Vertex to) {
   edges_.emplace_back(std::make_pair(from, to));
 }
 
+void ArcGraph::AddEdges(const std::vector<std::pair<Vertex, Vertex>>& edges) {
+  edges_.insert(edges_.end(), edges.begin(), edges.end());
+}
+
 void ArcGraph::GetNextVertices(Vertex vertex,
                                std::vector<Vertex>& vertices) const {
-  vertices.clear();
-  for (auto [from, to] : edges_) {
-    if (from == vertex) {
-      vertices.emplace_back(to);
-    }
-  }
+  VertexSpan next = NextVertices(vertex);
+  vertices.assign(next.begin(), next.end());
 }
 
 void ArcGraph::GetPrevVertices(Vertex vertex,
                                std::vector<Vertex>& vertices) const {
-  vertices.clear();
-  for (auto [from, to] : edges_) {
-    if (from == vertex) {
-      vertices.emplace_back(to);
+  VertexSpan prev = PrevVertices(vertex);
+  vertices.assign(prev.begin(), prev.end());
+}
+
+VertexSpan ArcGraph::NextVertices(Vertex vertex) const {
+  BuildIndex();
+  return by_source_.Find(vertex);
+}
+
+VertexSpan ArcGraph::PrevVertices(Vertex vertex) const {
+  BuildIndex();
+  return by_target_.Find(vertex);
+}
+
+void ArcGraph::BuildIndex() const {
+  if (indexed_edges_ == edges_.size()) {
+    return;
+  }
+  auto tail = std::vector<std::pair<Vertex, Vertex>>(
+      edges_.begin() + indexed_edges_, edges_.end());
+  by_source_.Merge(tail);
+  for (auto& [from, to] : tail) {
+    std::swap(from, to);
+  }
+  by_target_.Merge(tail);
+  indexed_edges_ = edges_.size();
+}
+
+void ArcGraph::Index::Merge(std::vector<std::pair<Vertex, Vertex>>& tail) {
+  // Stable on both sides, so every vertex keeps its insertion order
+  std::stable_sort(tail.begin(), tail.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  auto merged_keys = std::vector<Vertex>();
+  auto merged_values = std::vector<Vertex>();
+  merged_keys.reserve(keys.size() + tail.size());
+  merged_values.reserve(keys.size() + tail.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < keys.size() || j < tail.size()) {
+    if (j == tail.size() || (i < keys.size() && keys[i] <= tail[j].first)) {
+      merged_keys.push_back(keys[i]);
+      merged_values.push_back(values[i]);
+      ++i;
+    } else {
+      merged_keys.push_back(tail[j].first);
+      merged_values.push_back(tail[j].second);
+      ++j;
     }
   }
-}
\ No newline at end of file
+  keys = std::move(merged_keys);
+  values = std::move(merged_values);
+}
+
+VertexSpan ArcGraph::Index::Find(Vertex key) const {
+  auto [first, last] = std::equal_range(keys.begin(), keys.end(), key);
+  return VertexSpan(values.data() + (first - keys.begin()),
+                    values.data() + (last - keys.begin()));
+}
@@ -9,25 +9,61 @@
 #include <vector>
 #include "IGraph.h"
 
+// Edge list with lazily maintained indices sorted by source and by target.
+// Appends only touch edges_; the next neighbor query sorts the unindexed
+// tail and merges it into the indices, after which lookups are binary
+// searches. Queries are not safe to run concurrently with a pending index
+// update: call BuildIndex() before sharing the graph between threads.
 class ArcGraph : public IGraph {
  public:
-  explicit ArcGraph(size_t num_vertices) : num_vertices_(num_vertices) {}
+  explicit ArcGraph(size_t num_vertices)
+      : num_vertices_(num_vertices), indexed_edges_(0) {}
 
   explicit ArcGraph(const IGraph* graph);
 
   void AddEdge(Vertex from, Vertex to) override;
 
+  void AddEdges(const std::vector<std::pair<Vertex, Vertex>>& edges);
+
   size_t VerticesCount() const override { return num_vertices_; }
 
+  size_t EdgesCount() const { return edges_.size(); }
+
+  const std::vector<std::pair<Vertex, Vertex>>& Edges() const {
+    return edges_;
+  }
+
   void GetNextVertices(Vertex vertex,
                        std::vector<Vertex>& vertices) const override;
 
   void GetPrevVertices(Vertex vertex,
                        std::vector<Vertex>& vertices) const override;
 
+  VertexSpan NextVertices(Vertex vertex) const override;
+
+  VertexSpan PrevVertices(Vertex vertex) const override;
+
+  // Brings both indices up to date with all appended edges
+  void BuildIndex() const;
+
  private:
+  friend class GraphBuilder;
+
+  // Sorted keys with values alongside, so a key range maps to a value span
+  struct Index {
+    std::vector<Vertex> keys;
+    std::vector<Vertex> values;
+
+    void Merge(std::vector<std::pair<Vertex, Vertex>>& tail);
+
+    VertexSpan Find(Vertex key) const;
+  };
+
   size_t num_vertices_;
   std::vector<std::pair<Vertex, Vertex>> edges_;
+  mutable size_t indexed_edges_;
+  mutable Index by_source_;
+  mutable Index by_target_;
 };
 
 #endif  // INC_1_A_ARCGRAPH_H
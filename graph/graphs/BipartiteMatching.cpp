@@ -0,0 +1,221 @@
+#include "BipartiteMatching.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace {
+
+const Vertex kNoMate = MatchingResult::kNoMate;
+const size_t kInfinite = std::numeric_limits<size_t>::max();
+
+class HopcroftKarp {
+ public:
+  HopcroftKarp(const IGraph& graph, const std::vector<uint8_t>& side,
+               size_t num_threads)
+      : offsets_(graph.VerticesCount() + 1, 0),
+        mate_(graph.VerticesCount(), kNoMate),
+        distance_(graph.VerticesCount(), kInfinite),
+        current_(graph.VerticesCount(), 0),
+        num_threads_(num_threads) {
+    size_t num_vertices = graph.VerticesCount();
+    assert(side.size() == num_vertices);
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (side[vertex] == 0) {
+        left_.push_back(vertex);
+      }
+    }
+    ParallelFor(0, left_.size(), num_threads_,
+                [&](size_t begin, size_t end, size_t) {
+                  for (size_t i = begin; i < end; ++i) {
+                    Vertex vertex = left_[i];
+                    offsets_[vertex + 1] = graph.NextVertices(vertex).size();
+                  }
+                });
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      offsets_[vertex + 1] += offsets_[vertex];
+    }
+    targets_.resize(offsets_.back());
+    ParallelFor(0, left_.size(), num_threads_,
+                [&](size_t begin, size_t end, size_t) {
+                  for (size_t i = begin; i < end; ++i) {
+                    size_t arc = offsets_[left_[i]];
+                    for (auto next : graph.NextVertices(left_[i])) {
+                      assert(side[next] == 1);
+                      targets_[arc++] = next;
+                    }
+                  }
+                });
+    queue_.reserve(left_.size());
+  }
+
+  // Every side-0 vertex takes the first unclaimed neighbour; the claims are
+  // atomic, so threads can share the side-1 vertices
+  void MatchGreedily() {
+    std::vector<std::atomic<uint8_t>> claimed(mate_.size());
+    std::vector<size_t> counts(num_threads_, 0);
+    ParallelFor(0, left_.size(), num_threads_,
+                [&](size_t begin, size_t end, size_t thread) {
+                  for (size_t i = begin; i < end; ++i) {
+                    Vertex vertex = left_[i];
+                    for (size_t arc = offsets_[vertex];
+                         arc < offsets_[vertex + 1]; ++arc) {
+                      Vertex next = targets_[arc];
+                      uint8_t expected = 0;
+                      if (claimed[next].load(std::memory_order_relaxed) == 0 &&
+                          claimed[next].compare_exchange_strong(expected, 1)) {
+                        mate_[vertex] = next;
+                        mate_[next] = vertex;
+                        ++counts[thread];
+                        break;
+                      }
+                    }
+                  }
+                });
+    for (auto count : counts) {
+      size_ += count;
+    }
+  }
+
+  void Run() {
+    while (BuildLayers()) {
+      for (auto vertex : left_) {
+        current_[vertex] = offsets_[vertex];
+      }
+      for (auto vertex : left_) {
+        if (mate_[vertex] == kNoMate && Augment(vertex)) {
+          ++size_;
+        }
+      }
+    }
+  }
+
+  MatchingResult Result() {
+    MatchingResult result;
+    result.size = size_;
+    result.mate = std::move(mate_);
+    return result;
+  }
+
+ private:
+  // BFS from the free side-0 vertices, alternating unmatched and matched
+  // edges; false once no free side-1 vertex can be reached
+  bool BuildLayers() {
+    queue_.clear();
+    for (auto vertex : left_) {
+      if (mate_[vertex] == kNoMate) {
+        distance_[vertex] = 0;
+        queue_.push_back(vertex);
+      } else {
+        distance_[vertex] = kInfinite;
+      }
+    }
+    free_distance_ = kInfinite;
+    for (size_t head = 0; head < queue_.size(); ++head) {
+      Vertex vertex = queue_[head];
+      if (distance_[vertex] + 1 >= free_distance_) {
+        break;
+      }
+      for (size_t arc = offsets_[vertex]; arc < offsets_[vertex + 1]; ++arc) {
+        Vertex mate = mate_[targets_[arc]];
+        if (mate == kNoMate) {
+          free_distance_ = distance_[vertex] + 1;
+        } else if (distance_[mate] == kInfinite) {
+          distance_[mate] = distance_[vertex] + 1;
+          queue_.push_back(mate);
+        }
+      }
+    }
+    return free_distance_ != kInfinite;
+  }
+
+  // DFS along the layers from a free side-0 vertex; the stack holds the
+  // side-0 vertices of the path and each one's current arc the edge taken
+  // out of it. Dead ends leave the layering for the rest of the phase.
+  bool Augment(Vertex root) {
+    stack_.clear();
+    stack_.push_back(root);
+    while (!stack_.empty()) {
+      Vertex vertex = stack_.back();
+      if (current_[vertex] == offsets_[vertex + 1]) {
+        distance_[vertex] = kInfinite;
+        stack_.pop_back();
+        if (!stack_.empty()) {
+          ++current_[stack_.back()];
+        }
+        continue;
+      }
+      Vertex mate = mate_[targets_[current_[vertex]]];
+      if (mate == kNoMate) {
+        if (distance_[vertex] + 1 == free_distance_) {
+          for (auto left : stack_) {
+            Vertex right = targets_[current_[left]];
+            mate_[left] = right;
+            mate_[right] = left;
+          }
+          return true;
+        }
+        ++current_[vertex];
+      } else if (distance_[mate] == distance_[vertex] + 1) {
+        stack_.push_back(mate);
+      } else {
+        ++current_[vertex];
+      }
+    }
+    return false;
+  }
+
+  std::vector<Vertex> left_;
+  std::vector<size_t> offsets_;
+  std::vector<Vertex> targets_;
+  std::vector<Vertex> mate_;
+  std::vector<size_t> distance_;
+  std::vector<size_t> current_;
+  std::vector<Vertex> queue_;
+  std::vector<Vertex> stack_;
+  size_t free_distance_ = kInfinite;
+  size_t size_ = 0;
+  size_t num_threads_;
+};
+
+}  // namespace
+
+BipartitionResult FindBipartition(const IGraph& graph) {
+  size_t num_vertices = graph.VerticesCount();
+  const uint8_t kNoSide = 2;
+  BipartitionResult result;
+  result.side.assign(num_vertices, kNoSide);
+  std::vector<Vertex> stack;
+  for (Vertex start = 0; start < num_vertices; ++start) {
+    if (result.side[start] != kNoSide) {
+      continue;
+    }
+    result.side[start] = 0;
+    stack.push_back(start);
+    while (!stack.empty()) {
+      Vertex current = stack.back();
+      stack.pop_back();
+      for (auto next : graph.NextVertices(current)) {
+        if (result.side[next] == kNoSide) {
+          result.side[next] = 1 - result.side[current];
+          stack.push_back(next);
+        } else if (result.side[next] == result.side[current]) {
+          result.side.clear();
+          return result;
+        }
+      }
+    }
+  }
+  result.bipartite = true;
+  return result;
+}
+
+MatchingResult FindMaximumMatching(const IGraph& graph,
+                                   const std::vector<uint8_t>& side,
+                                   const MatchingOptions& options) {
+  HopcroftKarp matching(graph, side, std::max<size_t>(1, options.num_threads));
+  if (options.greedy_start) {
+    matching.MatchGreedily();
+  }
+  matching.Run();
+  return matching.Result();
+}
@@ -0,0 +1,44 @@
+#ifndef INC_1_A_BIPARTITEMATCHING_H
+#define INC_1_A_BIPARTITEMATCHING_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "IGraph.h"
+#include "Parallel.h"
+
+struct BipartitionResult {
+  bool bipartite = false;
+  // 0 or 1 for every vertex; the first vertex of each component gets 0
+  std::vector<uint8_t> side;
+};
+
+// 2-colors every connected component of an undirected graph (every edge
+// stored both ways) with an explicit stack. A self-loop or any odd cycle
+// makes it not bipartite.
+BipartitionResult FindBipartition(const IGraph& graph);
+
+struct MatchingOptions {
+  // Start Hopcroft-Karp from a greedy maximal matching built in parallel
+  bool greedy_start = false;
+  size_t num_threads = DefaultThreadsCount();
+};
+
+struct MatchingResult {
+  static constexpr Vertex kNoMate = std::numeric_limits<Vertex>::max();
+
+  size_t size = 0;
+  // Matched neighbour of every vertex, or kNoMate
+  std::vector<Vertex> mate;
+};
+
+// Maximum matching of a bipartite undirected graph split by side (as found
+// by FindBipartition) with Hopcroft-Karp in O(E sqrt(V)). The edges of the
+// side-0 vertices are copied into one CSR array; every phase is a BFS
+// layering from the free side-0 vertices and iterative DFS augmentations
+// with current-arc pointers, all on flat per-vertex arrays.
+MatchingResult FindMaximumMatching(const IGraph& graph,
+                                   const std::vector<uint8_t>& side,
+                                   const MatchingOptions& options = {});
+
+#endif  // INC_1_A_BIPARTITEMATCHING_H
@@ -0,0 +1,189 @@
+#include "BitMatrixGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#ifdef __AVX2__
+// Per-byte popcount by nibble lookup, summed into four 64-bit lanes
+inline __m256i PopcountBytes(__m256i block) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0F);
+  __m256i low = _mm256_and_si256(block, low_mask);
+  __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_mask);
+  __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low),
+                                   _mm256_shuffle_epi8(lookup, high));
+  return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+inline size_t HorizontalSum(__m256i lanes) {
+  return _mm256_extract_epi64(lanes, 0) + _mm256_extract_epi64(lanes, 1) +
+         _mm256_extract_epi64(lanes, 2) + _mm256_extract_epi64(lanes, 3);
+}
+#endif
+
+// Rows are cache-line padded, so words is a multiple of 8 and both pointers
+// are 64-byte aligned.
+size_t PopcountRow(const uint64_t* row, size_t words) {
+  size_t count = 0;
+  size_t word = 0;
+#ifdef __AVX2__
+  __m256i lanes = _mm256_setzero_si256();
+  for (; word + 4 <= words; word += 4) {
+    __m256i block =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(row + word));
+    lanes = _mm256_add_epi64(lanes, PopcountBytes(block));
+  }
+  count = HorizontalSum(lanes);
+#endif
+  for (; word < words; ++word) {
+    count += __builtin_popcountll(row[word]);
+  }
+  return count;
+}
+
+size_t AndPopcount(const uint64_t* lhs, const uint64_t* rhs, size_t words) {
+  size_t count = 0;
+  size_t word = 0;
+#ifdef __AVX2__
+  __m256i lanes = _mm256_setzero_si256();
+  for (; word + 4 <= words; word += 4) {
+    __m256i block = _mm256_and_si256(
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(lhs + word)),
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(rhs + word)));
+    lanes = _mm256_add_epi64(lanes, PopcountBytes(block));
+  }
+  count = HorizontalSum(lanes);
+#endif
+  for (; word < words; ++word) {
+    count += __builtin_popcountll(lhs[word] & rhs[word]);
+  }
+  return count;
+}
+
+size_t OrPopcount(const uint64_t* lhs, const uint64_t* rhs, size_t words) {
+  size_t count = 0;
+  size_t word = 0;
+#ifdef __AVX2__
+  __m256i lanes = _mm256_setzero_si256();
+  for (; word + 4 <= words; word += 4) {
+    __m256i block = _mm256_or_si256(
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(lhs + word)),
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(rhs + word)));
+    lanes = _mm256_add_epi64(lanes, PopcountBytes(block));
+  }
+  count = HorizontalSum(lanes);
+#endif
+  for (; word < words; ++word) {
+    count += __builtin_popcountll(lhs[word] | rhs[word]);
+  }
+  return count;
+}
+
+}  // namespace
+
+BitMatrixGraph::BitMatrixGraph(size_t num_vertices, bool count_multi_edges)
+    : num_vertices_(num_vertices),
+      words_per_row_((num_vertices + kWordBits * kLineWords - 1) /
+                     (kWordBits * kLineWords) * kLineWords),
+      count_multi_edges_(count_multi_edges) {
+  size_t bytes = std::max<size_t>(1, num_vertices_ * words_per_row_) *
+                 sizeof(uint64_t);
+  bytes = (bytes + 63) / 64 * 64;
+  bits_.reset(static_cast<uint64_t*>(std::aligned_alloc(64, bytes)));
+  assert(bits_ != nullptr);
+  std::memset(bits_.get(), 0, bytes);
+}
+
+BitMatrixGraph::BitMatrixGraph(const IGraph* graph, bool count_multi_edges)
+    : BitMatrixGraph(graph->VerticesCount(), count_multi_edges) {
+  for (Vertex from = 0; from < num_vertices_; ++from) {
+    for (auto to : graph->NextVertices(from)) {
+      AddEdge(from, to);
+    }
+  }
+}
+
+void BitMatrixGraph::AddEdge(Vertex from, Vertex to) {
+  assert(from < num_vertices_ && to < num_vertices_);
+  if (HasEdge(from, to)) {
+    if (count_multi_edges_) {
+      ++extra_edges_[static_cast<uint64_t>(from) * num_vertices_ + to];
+    }
+    return;
+  }
+  Row(from)[to / kWordBits] |= uint64_t(1) << (to % kWordBits);
+}
+
+size_t BitMatrixGraph::EdgeMultiplicity(Vertex from, Vertex to) const {
+  if (!HasEdge(from, to)) {
+    return 0;
+  }
+  auto found =
+      extra_edges_.find(static_cast<uint64_t>(from) * num_vertices_ + to);
+  return found == extra_edges_.end() ? 1 : 1 + found->second;
+}
+
+void BitMatrixGraph::GetNextVertices(Vertex vertex,
+                                     std::vector<Vertex>& vertices) const {
+  vertices.clear();
+  ForEachNextVertex(vertex,
+                    [&](Vertex next) { vertices.emplace_back(next); });
+}
+
+void BitMatrixGraph::GetPrevVertices(Vertex vertex,
+                                     std::vector<Vertex>& vertices) const {
+  vertices.clear();
+  for (Vertex from = 0; from < num_vertices_; ++from) {
+    if (HasEdge(from, vertex)) {
+      vertices.emplace_back(from);
+    }
+  }
+}
+
+size_t BitMatrixGraph::OutDegree(Vertex vertex) const {
+  return PopcountRow(Row(vertex), words_per_row_);
+}
+
+size_t BitMatrixGraph::CommonNeighborsCount(Vertex a, Vertex b) const {
+  return AndPopcount(Row(a), Row(b), words_per_row_);
+}
+
+size_t BitMatrixGraph::NeighborhoodUnionSize(Vertex a, Vertex b) const {
+  return OrPopcount(Row(a), Row(b), words_per_row_);
+}
+
+size_t BitMatrixGraph::TrianglesCount() const {
+  // Every triangle u < v < w is seen once: from edge (u, v), counting common
+  // neighbors above v. Whole cache lines above v go to the AND kernel, the
+  // line holding v is masked by hand.
+  size_t triangles = 0;
+  for (Vertex u = 0; u < num_vertices_; ++u) {
+    const uint64_t* row_u = Row(u);
+    ForEachNextVertex(u, [&](Vertex v) {
+      if (v <= u) {
+        return;
+      }
+      const uint64_t* row_v = Row(v);
+      size_t first_word = (v + 1) / kWordBits;
+      size_t line_end = std::min(
+          words_per_row_, (first_word / kLineWords + 1) * kLineWords);
+      for (size_t word = first_word; word < line_end; ++word) {
+        uint64_t bits = row_u[word] & row_v[word];
+        if (word == first_word) {
+          bits &= ~uint64_t(0) << ((v + 1) % kWordBits);
+        }
+        triangles += __builtin_popcountll(bits);
+      }
+      triangles += AndPopcount(row_u + line_end, row_v + line_end,
+                               words_per_row_ - line_end);
+    });
+  }
+  return triangles;
+}
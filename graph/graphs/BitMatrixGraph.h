@@ -0,0 +1,83 @@
+#ifndef INC_1_A_BITMATRIXGRAPH_H
+#define INC_1_A_BITMATRIXGRAPH_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "IGraph.h"
+
+// Adjacency matrix packed into bits, 64 vertices per word. Every row is
+// padded to a whole number of 64-byte cache lines, so row kernels work on
+// aligned blocks. Parallel edges collapse into one bit unless multi-edge
+// counting is enabled, in which case the extra copies go to a side table.
+class BitMatrixGraph : public IGraph {
+ public:
+  explicit BitMatrixGraph(size_t num_vertices, bool count_multi_edges = false);
+
+  explicit BitMatrixGraph(const IGraph* graph, bool count_multi_edges = false);
+
+  void AddEdge(Vertex from, Vertex to) override;
+
+  size_t VerticesCount() const override { return num_vertices_; }
+
+  void GetNextVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  void GetPrevVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  bool HasEdge(Vertex from, Vertex to) const override {
+    return (Row(from)[to / kWordBits] >> (to % kWordBits)) & 1;
+  }
+
+  // Number of (from, to) edges added; 0 or 1 without multi-edge counting
+  size_t EdgeMultiplicity(Vertex from, Vertex to) const;
+
+  template <typename Callback>
+  void ForEachNextVertex(Vertex vertex, Callback callback) const {
+    const uint64_t* row = Row(vertex);
+    for (size_t word = 0; word < words_per_row_; ++word) {
+      uint64_t bits = row[word];
+      while (bits != 0) {
+        callback(word * kWordBits + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+  }
+
+  size_t OutDegree(Vertex vertex) const;
+
+  // |N(a) & N(b)| over out-neighborhoods
+  size_t CommonNeighborsCount(Vertex a, Vertex b) const;
+
+  // |N(a) | N(b)| over out-neighborhoods
+  size_t NeighborhoodUnionSize(Vertex a, Vertex b) const;
+
+  // Triangles of an undirected graph (the matrix is expected to be symmetric)
+  size_t TrianglesCount() const;
+
+ private:
+  static constexpr size_t kWordBits = 64;
+  static constexpr size_t kLineWords = 8;
+
+  struct AlignedFree {
+    void operator()(uint64_t* pointer) const { std::free(pointer); }
+  };
+
+  const uint64_t* Row(Vertex vertex) const {
+    return bits_.get() + vertex * words_per_row_;
+  }
+
+  uint64_t* Row(Vertex vertex) { return bits_.get() + vertex * words_per_row_; }
+
+  size_t num_vertices_;
+  size_t words_per_row_;
+  std::unique_ptr<uint64_t[], AlignedFree> bits_;
+  bool count_multi_edges_;
+  // (from * V + to) -> number of copies beyond the first one
+  std::unordered_map<uint64_t, size_t> extra_edges_;
+};
+
+#endif  // INC_1_A_BITMATRIXGRAPH_H
@@ -0,0 +1,172 @@
+#include "BreadthFirstSearch.h"
+#include <atomic>
+
+namespace {
+
+const size_t kWordBits = 64;
+
+std::vector<Vertex> Concatenate(std::vector<std::vector<Vertex>>& parts) {
+  size_t total = 0;
+  for (const auto& part : parts) {
+    total += part.size();
+  }
+  std::vector<Vertex> result;
+  result.reserve(total);
+  for (auto& part : parts) {
+    result.insert(result.end(), part.begin(), part.end());
+    part.clear();
+  }
+  return result;
+}
+
+}  // namespace
+
+BreadthFirstSearch::BreadthFirstSearch(const IGraph& graph, BFSOptions options)
+    : graph_(graph), options_(std::move(options)) {
+  // Settle lazily built adjacency (ArcGraph indices) before threads start
+  if (graph_.VerticesCount() > 0) {
+    graph_.NextVertices(0);
+    graph_.PrevVertices(0);
+  }
+}
+
+BFSResult BreadthFirstSearch::Run(Vertex source) const {
+  return Run(std::vector<Vertex>(1, source));
+}
+
+BFSResult BreadthFirstSearch::Run(const std::vector<Vertex>& sources) const {
+  size_t num_vertices = graph_.VerticesCount();
+  size_t num_threads = std::max<size_t>(1, options_.num_threads);
+  BFSResult result;
+  result.levels.assign(num_vertices, kUnreached);
+  auto parents = std::vector<std::atomic<Vertex>>(num_vertices);
+  for (auto& parent : parents) {
+    parent.store(kNoVertex, std::memory_order_relaxed);
+  }
+  if (options_.count_paths) {
+    result.path_counts.assign(num_vertices, 0);
+  }
+
+  std::vector<Vertex> frontier;
+  for (auto source : sources) {
+    if (parents[source].load(std::memory_order_relaxed) == kNoVertex) {
+      parents[source].store(source, std::memory_order_relaxed);
+      result.levels[source] = 0;
+      frontier.push_back(source);
+      if (options_.count_paths) {
+        result.path_counts[source] = 1;
+      }
+    }
+  }
+
+  size_t unexplored_edges = 0;
+  if (options_.direction_optimizing) {
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      unexplored_edges += graph_.NextVertices(vertex).size();
+    }
+  }
+
+  auto frontier_bits = std::vector<uint64_t>((num_vertices + kWordBits - 1) /
+                                             kWordBits);
+  auto parts = std::vector<std::vector<Vertex>>(num_threads);
+  bool bottom_up = false;
+  for (size_t level = 0; !frontier.empty(); ++level) {
+    if (options_.target != kNoVertex &&
+        result.levels[options_.target] != kUnreached) {
+      break;
+    }
+
+    if (options_.direction_optimizing) {
+      size_t frontier_edges = 0;
+      for (auto vertex : frontier) {
+        frontier_edges += graph_.NextVertices(vertex).size();
+      }
+      unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+      if (!bottom_up && frontier_edges > unexplored_edges / options_.alpha) {
+        bottom_up = true;
+      } else if (bottom_up && frontier.size() < num_vertices / options_.beta) {
+        bottom_up = false;
+      }
+    }
+
+    // Threads are started afresh on every level, so small steps (the first
+    // levels, long narrow graphs) stay on the calling thread
+    size_t step_work = bottom_up ? num_vertices : frontier.size();
+    size_t step_threads = step_work >= kMinParallelStep ? num_threads : 1;
+    if (!bottom_up) {
+      ParallelFor(
+          0, frontier.size(), step_threads,
+          [&](size_t begin, size_t end, size_t thread) {
+            for (size_t i = begin; i < end; ++i) {
+              Vertex current = frontier[i];
+              for (auto next : graph_.NextVertices(current)) {
+                Vertex unclaimed = kNoVertex;
+                if (parents[next].load(std::memory_order_relaxed) ==
+                        kNoVertex &&
+                    Accepts(current, next) &&
+                    parents[next].compare_exchange_strong(
+                        unclaimed, current, std::memory_order_relaxed)) {
+                  result.levels[next] = level + 1;
+                  parts[thread].push_back(next);
+                }
+              }
+            }
+          });
+    } else {
+      std::fill(frontier_bits.begin(), frontier_bits.end(), 0);
+      for (auto vertex : frontier) {
+        frontier_bits[vertex / kWordBits] |= uint64_t(1)
+                                             << (vertex % kWordBits);
+      }
+      // Whole words per thread, so no vertex is shared between threads
+      ParallelFor(
+          0, frontier_bits.size(), step_threads,
+          [&](size_t begin, size_t end, size_t thread) {
+            Vertex last = std::min(num_vertices, end * kWordBits);
+            for (Vertex vertex = begin * kWordBits; vertex < last; ++vertex) {
+              if (parents[vertex].load(std::memory_order_relaxed) !=
+                  kNoVertex) {
+                continue;
+              }
+              for (auto prev : graph_.PrevVertices(vertex)) {
+                if (((frontier_bits[prev / kWordBits] >> (prev % kWordBits)) &
+                     1) &&
+                    Accepts(prev, vertex)) {
+                  parents[vertex].store(prev, std::memory_order_relaxed);
+                  result.levels[vertex] = level + 1;
+                  parts[thread].push_back(vertex);
+                  break;
+                }
+              }
+            }
+          });
+    }
+    frontier = Concatenate(parts);
+
+    if (options_.count_paths) {
+      // Pull counts from every predecessor on the previous level
+      size_t count_threads =
+          frontier.size() >= kMinParallelStep ? num_threads : 1;
+      ParallelFor(0, frontier.size(), count_threads,
+                  [&](size_t begin, size_t end, size_t) {
+                    for (size_t i = begin; i < end; ++i) {
+                      Vertex vertex = frontier[i];
+                      uint64_t count = 0;
+                      for (auto prev : graph_.PrevVertices(vertex)) {
+                        if (result.levels[prev] == level &&
+                            Accepts(prev, vertex)) {
+                          count += result.path_counts[prev];
+                        }
+                      }
+                      result.path_counts[vertex] = count;
+                    }
+                  });
+    }
+  }
+
+  result.parents.resize(num_vertices);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    result.parents[vertex] = parents[vertex].load(std::memory_order_relaxed);
+  }
+  return result;
+}
@@ -0,0 +1,63 @@
+#ifndef INC_1_A_BREADTHFIRSTSEARCH_H
+#define INC_1_A_BREADTHFIRSTSEARCH_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+#include "IGraph.h"
+#include "Parallel.h"
+
+const Vertex kNoVertex = std::numeric_limits<Vertex>::max();
+const size_t kUnreached = std::numeric_limits<size_t>::max();
+
+struct BFSOptions {
+  size_t num_threads = DefaultThreadsCount();
+  // Switch between top-down and bottom-up steps (Beamer et al.)
+  bool direction_optimizing = true;
+  // Go bottom-up once frontier edges exceed unexplored edges / alpha,
+  // back top-down once the frontier shrinks below |V| / beta
+  double alpha = 15;
+  double beta = 18;
+  // Also count shortest paths to every vertex, modulo 2^64: after each
+  // level, its vertices pull the counts of their predecessors on the level
+  // before. PathCounter gives exact, modular or capped counts instead.
+  bool count_paths = false;
+  // Stop as soon as the target's level is complete
+  Vertex target = kNoVertex;
+  // Edges (from, to) rejected by the filter are ignored
+  std::function<bool(Vertex, Vertex)> edge_filter;
+};
+
+struct BFSResult {
+  std::vector<size_t> levels;         // kUnreached if not reached
+  std::vector<Vertex> parents;        // sources are their own parents
+  std::vector<uint64_t> path_counts;  // empty unless count_paths is set
+};
+
+// Level-synchronous BFS over any IGraph. Top-down steps split the frontier
+// between threads and claim vertices with CAS on the parent array; bottom-up
+// steps split the vertex range by 64-vertex words and test predecessors
+// against a frontier bitmap. Needs consistent NextVertices/PrevVertices.
+class BreadthFirstSearch {
+ public:
+  explicit BreadthFirstSearch(const IGraph& graph,
+                              BFSOptions options = BFSOptions());
+
+  BFSResult Run(Vertex source) const;
+
+  BFSResult Run(const std::vector<Vertex>& sources) const;
+
+ private:
+  // Levels with less work than this run on one thread
+  static constexpr size_t kMinParallelStep = 1024;
+
+  bool Accepts(Vertex from, Vertex to) const {
+    return !options_.edge_filter || options_.edge_filter(from, to);
+  }
+
+  const IGraph& graph_;
+  BFSOptions options_;
+};
+
+#endif  // INC_1_A_BREADTHFIRSTSEARCH_H
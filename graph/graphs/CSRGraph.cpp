@@ -0,0 +1,64 @@
+#include "CSRGraph.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+CSRGraph::CSRGraph(const IGraph* graph) {
+  size_t num_vertices = graph->VerticesCount();
+  next_offsets_.reserve(num_vertices + 1);
+  next_offsets_.push_back(0);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    VertexSpan next = graph->NextVertices(vertex);
+    next_targets_.insert(next_targets_.end(), next.begin(), next.end());
+    next_offsets_.push_back(next_targets_.size());
+  }
+  BuildReverse();
+}
+
+CSRGraph::CSRGraph(std::vector<size_t>&& next_offsets,
+                   std::vector<Vertex>&& next_targets)
+    : next_offsets_(std::move(next_offsets)),
+      next_targets_(std::move(next_targets)) {
+  assert(!next_offsets_.empty());
+  assert(next_offsets_.back() == next_targets_.size());
+  BuildReverse();
+}
+
+void CSRGraph::AddEdge(Vertex /*from*/, Vertex /*to*/) {
+  // Dropping the edge silently would be worse than stopping, even with
+  // asserts compiled out
+  std::fputs("CSRGraph is immutable\n", stderr);
+  std::abort();
+}
+
+void CSRGraph::GetNextVertices(Vertex vertex,
+                               std::vector<Vertex>& vertices) const {
+  VertexSpan next = NextVertices(vertex);
+  vertices.assign(next.begin(), next.end());
+}
+
+void CSRGraph::GetPrevVertices(Vertex vertex,
+                               std::vector<Vertex>& vertices) const {
+  VertexSpan prev = PrevVertices(vertex);
+  vertices.assign(prev.begin(), prev.end());
+}
+
+void CSRGraph::BuildReverse() {
+  // Counting sort of the forward edges by target
+  size_t num_vertices = VerticesCount();
+  prev_offsets_.assign(num_vertices + 1, 0);
+  for (auto to : next_targets_) {
+    ++prev_offsets_[to + 1];
+  }
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    prev_offsets_[vertex + 1] += prev_offsets_[vertex];
+  }
+  prev_sources_.resize(next_targets_.size());
+  auto position = std::vector<size_t>(prev_offsets_.begin(),
+                                      prev_offsets_.end() - 1);
+  for (Vertex from = 0; from < num_vertices; ++from) {
+    for (size_t i = next_offsets_[from]; i < next_offsets_[from + 1]; ++i) {
+      prev_sources_[position[next_targets_[i]]++] = from;
+    }
+  }
+}
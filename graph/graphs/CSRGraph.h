@@ -0,0 +1,61 @@
+#ifndef INC_1_A_CSRGRAPH_H
+#define INC_1_A_CSRGRAPH_H
+
+#include <vector>
+#include "IGraph.h"
+
+// Immutable compressed sparse row graph: the neighbors of vertex v are
+// targets[offsets[v]..offsets[v + 1]), stored for both directions.
+class CSRGraph : public IGraph {
+ public:
+  explicit CSRGraph(const IGraph* graph);
+
+  // Takes ownership of a ready forward CSR and derives the reverse one.
+  CSRGraph(std::vector<size_t>&& next_offsets,
+           std::vector<Vertex>&& next_targets);
+
+  // The structure is frozen after construction: aborts.
+  void AddEdge(Vertex from, Vertex to) override;
+
+  size_t VerticesCount() const override { return next_offsets_.size() - 1; }
+
+  size_t EdgesCount() const { return next_targets_.size(); }
+
+  void GetNextVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  void GetPrevVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  VertexSpan NextVertices(Vertex vertex) const override {
+    return VertexSpan(next_targets_.data() + next_offsets_[vertex],
+                      next_targets_.data() + next_offsets_[vertex + 1]);
+  }
+
+  VertexSpan PrevVertices(Vertex vertex) const override {
+    return VertexSpan(prev_sources_.data() + prev_offsets_[vertex],
+                      prev_sources_.data() + prev_offsets_[vertex + 1]);
+  }
+
+  const std::vector<size_t>& NextOffsets() const { return next_offsets_; }
+
+  const std::vector<Vertex>& NextTargets() const { return next_targets_; }
+
+  const std::vector<size_t>& PrevOffsets() const { return prev_offsets_; }
+
+  const std::vector<Vertex>& PrevSources() const { return prev_sources_; }
+
+ private:
+  friend class GraphBuilder;
+
+  CSRGraph() = default;
+
+  void BuildReverse();
+
+  std::vector<size_t> next_offsets_;
+  std::vector<Vertex> next_targets_;
+  std::vector<size_t> prev_offsets_;
+  std::vector<Vertex> prev_sources_;
+};
+
+#endif  // INC_1_A_CSRGRAPH_H
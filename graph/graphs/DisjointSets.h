@@ -0,0 +1,65 @@
+#ifndef INC_1_A_DISJOINTSETS_H
+#define INC_1_A_DISJOINTSETS_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "IGraph.h"
+
+// Union-find over vertices with union by rank and full path compression
+class DisjointSets {
+ public:
+  explicit DisjointSets(size_t num_vertices)
+      : parent_(num_vertices), rank_(num_vertices, 0) {
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      parent_[vertex] = vertex;
+    }
+  }
+
+  size_t VerticesCount() const { return parent_.size(); }
+
+  Vertex Find(Vertex vertex) {
+    Vertex root = vertex;
+    while (parent_[root] != root) {
+      root = parent_[root];
+    }
+    while (parent_[vertex] != root) {
+      Vertex next = parent_[vertex];
+      parent_[vertex] = root;
+      vertex = next;
+    }
+    return root;
+  }
+
+  // Find without path compression: safe from many threads while no one
+  // unites
+  Vertex Root(Vertex vertex) const {
+    while (parent_[vertex] != vertex) {
+      vertex = parent_[vertex];
+    }
+    return vertex;
+  }
+
+  // False if both were in one set already
+  bool Unite(Vertex first, Vertex second) {
+    first = Find(first);
+    second = Find(second);
+    if (first == second) {
+      return false;
+    }
+    if (rank_[first] < rank_[second]) {
+      std::swap(first, second);
+    }
+    parent_[second] = first;
+    if (rank_[first] == rank_[second]) {
+      ++rank_[first];
+    }
+    return true;
+  }
+
+ private:
+  std::vector<Vertex> parent_;
+  std::vector<uint8_t> rank_;
+};
+
+#endif  // INC_1_A_DISJOINTSETS_H
@@ -0,0 +1,153 @@
+#include "FlatVertexSet.h"
+#include <algorithm>
+#include <utility>
+
+FlatVertexMultiset::FlatVertexMultiset(const FlatVertexMultiset& other)
+    : capacity_(other.capacity_),
+      log_capacity_(other.log_capacity_),
+      distinct_(other.distinct_),
+      size_(other.size_) {
+  std::copy(other.inline_, other.inline_ + kInlineCapacity, inline_);
+  if (!other.IsInline()) {
+    table_.reset(new Slot[capacity_]);
+    std::copy(other.table_.get(), other.table_.get() + capacity_,
+              table_.get());
+  }
+}
+
+FlatVertexMultiset::FlatVertexMultiset(FlatVertexMultiset&& other) noexcept {
+  Swap(other);
+}
+
+FlatVertexMultiset& FlatVertexMultiset::operator=(
+    FlatVertexMultiset other) noexcept {
+  Swap(other);
+  return *this;
+}
+
+void FlatVertexMultiset::Swap(FlatVertexMultiset& other) noexcept {
+  std::swap(inline_, other.inline_);
+  std::swap(table_, other.table_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(log_capacity_, other.log_capacity_);
+  std::swap(distinct_, other.distinct_);
+  std::swap(size_, other.size_);
+}
+
+size_t FlatVertexMultiset::Probe(Vertex vertex) const {
+  if (IsInline()) {
+    for (size_t i = 0; i < kInlineCapacity; ++i) {
+      if (inline_[i].count != 0 && inline_[i].vertex == vertex) {
+        return i;
+      }
+    }
+    return kInlineCapacity;
+  }
+  // Robin Hood invariant: stop once we are farther from home than the
+  // resident element
+  size_t mask = capacity_ - 1;
+  size_t index = HomeSlot(vertex);
+  for (uint32_t distance = 0;; ++distance, index = (index + 1) & mask) {
+    const Slot& slot = table_[index];
+    if (slot.count == 0 || slot.distance < distance) {
+      return capacity_;
+    }
+    if (slot.vertex == vertex) {
+      return index;
+    }
+  }
+}
+
+size_t FlatVertexMultiset::Count(Vertex vertex) const {
+  const Slot* slot = Find(vertex);
+  return slot == nullptr ? 0 : slot->count;
+}
+
+void FlatVertexMultiset::Insert(Vertex vertex) {
+  ++size_;
+  Slot* found = Find(vertex);
+  if (found != nullptr) {
+    ++found->count;
+    return;
+  }
+  Slot slot;
+  slot.vertex = vertex;
+  slot.count = 1;
+  if (IsInline() && distinct_ == kInlineCapacity) {
+    Rehash(4);
+  } else if (!IsInline() && (distinct_ + 1) * 8 > capacity_ * 7) {
+    Rehash(log_capacity_ + 1);
+  }
+  InsertNew(slot);
+  ++distinct_;
+}
+
+void FlatVertexMultiset::InsertNew(Slot slot) {
+  if (IsInline()) {
+    for (auto& inline_slot : inline_) {
+      if (inline_slot.count == 0) {
+        inline_slot = slot;
+        return;
+      }
+    }
+  }
+  size_t mask = capacity_ - 1;
+  size_t index = HomeSlot(slot.vertex);
+  slot.distance = 0;
+  for (;; ++slot.distance, index = (index + 1) & mask) {
+    Slot& resident = table_[index];
+    if (resident.count == 0) {
+      resident = slot;
+      return;
+    }
+    if (resident.distance < slot.distance) {
+      std::swap(resident, slot);
+    }
+  }
+}
+
+bool FlatVertexMultiset::Erase(Vertex vertex) {
+  Slot* found = Find(vertex);
+  if (found == nullptr) {
+    return false;
+  }
+  --size_;
+  if (--found->count != 0) {
+    return true;
+  }
+  --distinct_;
+  if (IsInline()) {
+    *found = Slot();
+    return true;
+  }
+  // Backward shift deletion keeps probe sequences gap-free
+  size_t mask = capacity_ - 1;
+  size_t index = found - table_.get();
+  size_t next = (index + 1) & mask;
+  while (table_[next].count != 0 && table_[next].distance != 0) {
+    table_[index] = table_[next];
+    --table_[index].distance;
+    index = next;
+    next = (next + 1) & mask;
+  }
+  table_[index] = Slot();
+  return true;
+}
+
+void FlatVertexMultiset::Rehash(size_t log_capacity) {
+  size_t old_capacity = Capacity();
+  std::unique_ptr<Slot[]> old_table = std::move(table_);
+  Slot old_inline[kInlineCapacity];
+  std::copy(inline_, inline_ + kInlineCapacity, old_inline);
+  std::fill(inline_, inline_ + kInlineCapacity, Slot());
+  const Slot* old_slots = old_table ? old_table.get() : old_inline;
+
+  log_capacity_ = log_capacity;
+  capacity_ = size_t(1) << log_capacity;
+  table_.reset(new Slot[capacity_]);
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_slots[i].count != 0) {
+      InsertNew(old_slots[i]);
+    }
+  }
+}
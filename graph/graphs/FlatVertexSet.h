@@ -0,0 +1,93 @@
+#ifndef INC_1_A_FLATVERTEXSET_H
+#define INC_1_A_FLATVERTEXSET_H
+
+#include <cstdint>
+#include <memory>
+#include "IGraph.h"
+
+// Multiset of vertices on open addressing with Robin Hood probing. Each
+// distinct vertex takes one slot with a multiplicity counter; the first few
+// live inline in the object, so low-degree vertices never touch the heap.
+class FlatVertexMultiset {
+ public:
+  FlatVertexMultiset() = default;
+
+  FlatVertexMultiset(const FlatVertexMultiset& other);
+
+  FlatVertexMultiset(FlatVertexMultiset&& other) noexcept;
+
+  FlatVertexMultiset& operator=(FlatVertexMultiset other) noexcept;
+
+  void Swap(FlatVertexMultiset& other) noexcept;
+
+  void Insert(Vertex vertex);
+
+  // Removes one copy; returns false if there was none
+  bool Erase(Vertex vertex);
+
+  size_t Count(Vertex vertex) const;
+
+  bool Contains(Vertex vertex) const { return Count(vertex) != 0; }
+
+  // Number of elements, counting multiplicity
+  size_t Size() const { return size_; }
+
+  // Calls callback once per copy of every element
+  template <typename Callback>
+  void ForEach(Callback callback) const {
+    const Slot* slots = Slots();
+    for (size_t i = 0; i < Capacity(); ++i) {
+      for (uint32_t copy = 0; copy < slots[i].count; ++copy) {
+        callback(slots[i].vertex);
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    Vertex vertex = 0;
+    uint32_t count = 0;  // 0 marks an empty slot
+    uint32_t distance = 0;
+  };
+
+  static constexpr size_t kInlineCapacity = 4;
+
+  bool IsInline() const { return table_ == nullptr; }
+
+  size_t Capacity() const { return IsInline() ? kInlineCapacity : capacity_; }
+
+  const Slot* Slots() const { return IsInline() ? inline_ : table_.get(); }
+
+  Slot* Slots() { return IsInline() ? inline_ : table_.get(); }
+
+  size_t HomeSlot(Vertex vertex) const {
+    return (static_cast<uint64_t>(vertex) * 0x9E3779B97F4A7C15ULL) >>
+           (64 - log_capacity_);
+  }
+
+  // Index of the vertex's slot in Slots(), Capacity() if it is absent
+  size_t Probe(Vertex vertex) const;
+
+  const Slot* Find(Vertex vertex) const {
+    size_t index = Probe(vertex);
+    return index == Capacity() ? nullptr : Slots() + index;
+  }
+
+  Slot* Find(Vertex vertex) {
+    size_t index = Probe(vertex);
+    return index == Capacity() ? nullptr : Slots() + index;
+  }
+
+  void InsertNew(Slot slot);
+
+  void Rehash(size_t log_capacity);
+
+  Slot inline_[kInlineCapacity];
+  std::unique_ptr<Slot[]> table_;
+  size_t capacity_ = 0;
+  size_t log_capacity_ = 0;
+  size_t distinct_ = 0;
+  size_t size_ = 0;
+};
+
+#endif  // INC_1_A_FLATVERTEXSET_H
@@ -0,0 +1,134 @@
+#include "Girth.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+const size_t kNoCycle = std::numeric_limits<size_t>::max();
+const size_t kChunk = 64;
+
+// Scratch space for one thread, reused across all of its searches
+class GirthWorkspace {
+ public:
+  explicit GirthWorkspace(size_t num_vertices)
+      : stamp_(num_vertices, 0),
+        level_(num_vertices),
+        parent_(num_vertices),
+        generation_(0) {
+    queue_.reserve(num_vertices);
+  }
+
+  // Shortest cycle through start shorter than bound; kNoCycle otherwise.
+  // On success the closing edge is left in closing_.
+  size_t Search(const IGraph& graph, Vertex start, size_t bound) {
+    ++generation_;
+    queue_.clear();
+    Visit(start, 0, start);
+    size_t best = kNoCycle;
+    for (size_t head = 0; head < queue_.size(); ++head) {
+      Vertex current = queue_[head];
+      // Cycles closed from here are at least 2 * level + 1 long
+      if (2 * level_[current] + 1 >= std::min(bound, best)) {
+        break;
+      }
+      for (auto next : graph.NextVertices(current)) {
+        if (next == current || next == parent_[current]) {
+          continue;
+        }
+        if (!IsVisited(next)) {
+          Visit(next, level_[current] + 1, current);
+        } else if (parent_[next] != current) {
+          size_t length = level_[current] + level_[next] + 1;
+          if (length < best) {
+            best = length;
+            closing_ = std::make_pair(current, next);
+          }
+        }
+      }
+    }
+    return best < bound ? best : kNoCycle;
+  }
+
+  // Cycle closed by the last found edge: the two tree paths up to their
+  // meeting point
+  std::vector<Vertex> Cycle() const {
+    auto [left, right] = closing_;
+    std::vector<Vertex> left_path;
+    std::vector<Vertex> right_path;
+    while (level_[left] > level_[right]) {
+      left_path.push_back(left);
+      left = parent_[left];
+    }
+    while (level_[right] > level_[left]) {
+      right_path.push_back(right);
+      right = parent_[right];
+    }
+    while (left != right) {
+      left_path.push_back(left);
+      right_path.push_back(right);
+      left = parent_[left];
+      right = parent_[right];
+    }
+    left_path.push_back(left);
+    left_path.insert(left_path.end(), right_path.rbegin(), right_path.rend());
+    return left_path;
+  }
+
+ private:
+  bool IsVisited(Vertex vertex) const {
+    return stamp_[vertex] == generation_;
+  }
+
+  void Visit(Vertex vertex, size_t level, Vertex parent) {
+    stamp_[vertex] = generation_;
+    level_[vertex] = level;
+    parent_[vertex] = parent;
+    queue_.push_back(vertex);
+  }
+
+  std::vector<uint64_t> stamp_;
+  std::vector<size_t> level_;
+  std::vector<Vertex> parent_;
+  std::vector<Vertex> queue_;
+  uint64_t generation_;
+  std::pair<Vertex, Vertex> closing_;
+};
+
+}  // namespace
+
+GirthResult FindGirth(const IGraph& graph, size_t num_threads) {
+  size_t num_vertices = graph.VerticesCount();
+  std::atomic<size_t> best(kNoCycle);
+  std::atomic<size_t> next_start(0);
+  std::mutex result_mutex;
+  GirthResult result;
+
+  num_threads = std::max<size_t>(1, num_threads);
+  ParallelFor(0, num_threads, num_threads, [&](size_t, size_t, size_t) {
+    GirthWorkspace workspace(num_vertices);
+    for (size_t chunk = next_start.fetch_add(kChunk); chunk < num_vertices;
+         chunk = next_start.fetch_add(kChunk)) {
+      for (Vertex start = chunk;
+           start < std::min(num_vertices, chunk + kChunk); ++start) {
+        size_t length = workspace.Search(graph, start, best.load());
+        if (length == kNoCycle) {
+          continue;
+        }
+        std::lock_guard<std::mutex> lock(result_mutex);
+        if (length < best.load()) {
+          best.store(length);
+          result.cycle = workspace.Cycle();
+        }
+      }
+    }
+  });
+
+  if (best.load() != kNoCycle) {
+    result.found = true;
+    result.length = best.load();
+  }
+  return result;
+}
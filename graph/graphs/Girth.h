@@ -0,0 +1,23 @@
+#ifndef INC_1_A_GIRTH_H
+#define INC_1_A_GIRTH_H
+
+#include <vector>
+#include "IGraph.h"
+#include "Parallel.h"
+
+struct GirthResult {
+  bool found = false;
+  size_t length = 0;
+  // Vertices of one shortest cycle, in order around it
+  std::vector<Vertex> cycle;
+};
+
+// Shortest cycle of an undirected graph (every edge stored both ways).
+// Self-loops and parallel edges are not counted as cycles. Runs a BFS from
+// every vertex on per-thread generation-stamped buffers, abandons a search
+// once its depth cannot beat the best cycle found by any thread, and hands
+// out start vertices to threads in small chunks.
+GirthResult FindGirth(const IGraph& graph,
+                      size_t num_threads = DefaultThreadsCount());
+
+#endif  // INC_1_A_GIRTH_H
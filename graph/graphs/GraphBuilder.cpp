@@ -0,0 +1,213 @@
+#include "GraphBuilder.h"
+#include <algorithm>
+#include <cassert>
+#include "Parallel.h"
+
+GraphBuilder::GraphBuilder(size_t num_vertices)
+    : num_vertices_(num_vertices),
+      num_threads_(DefaultThreadsCount()),
+      sort_adjacency_(false),
+      deduplicate_(false) {}
+
+void GraphBuilder::AddEdges(const std::vector<Edge>& edges) {
+  edges_.insert(edges_.end(), edges.begin(), edges.end());
+}
+
+void GraphBuilder::AddEdges(std::vector<Edge>&& edges) {
+  if (edges_.empty()) {
+    edges_ = std::move(edges);
+  } else {
+    AddEdges(edges);
+  }
+}
+
+void GraphBuilder::Scatter(bool reversed, std::vector<size_t>& offsets,
+                           std::vector<Vertex>& targets) const {
+  // Every thread keeps a count per vertex, so threads are capped at the
+  // average degree: the count arrays then take no more room than targets
+  size_t max_threads = std::max<size_t>(
+      1, edges_.size() / std::max<size_t>(1, num_vertices_));
+  size_t num_threads = std::max<size_t>(1, std::min(num_threads_, max_threads));
+  size_t block = (edges_.size() + num_threads - 1) / num_threads;
+  auto key = [&](const Edge& edge) {
+    return reversed ? edge.second : edge.first;
+  };
+  auto value = [&](const Edge& edge) {
+    return reversed ? edge.first : edge.second;
+  };
+
+  // Every thread counts degrees over its own block of edges
+  auto counts = std::vector<std::vector<size_t>>(
+      num_threads, std::vector<size_t>(num_vertices_, 0));
+  ParallelFor(0, num_threads, num_threads,
+              [&](size_t begin, size_t end, size_t) {
+                for (size_t thread = begin; thread < end; ++thread) {
+                  size_t edges_end =
+                      std::min(edges_.size(), (thread + 1) * block);
+                  for (size_t i = thread * block; i < edges_end; ++i) {
+                    assert(key(edges_[i]) < num_vertices_);
+                    assert(value(edges_[i]) < num_vertices_);
+                    ++counts[thread][key(edges_[i])];
+                  }
+                }
+              });
+
+  // Turn counts into per-thread write positions, keeping the input order.
+  // Each thread takes a range of vertices and walks the count arrays one
+  // after another over it.
+  offsets.assign(num_vertices_ + 1, 0);
+  ParallelFor(0, num_vertices_, num_threads,
+              [&](size_t begin, size_t end, size_t) {
+                for (const auto& thread_counts : counts) {
+                  for (Vertex vertex = begin; vertex < end; ++vertex) {
+                    offsets[vertex + 1] += thread_counts[vertex];
+                  }
+                }
+              });
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    offsets[vertex + 1] += offsets[vertex];
+  }
+  ParallelFor(0, num_vertices_, num_threads,
+              [&](size_t begin, size_t end, size_t) {
+                auto cursors = std::vector<size_t>(offsets.begin() + begin,
+                                                   offsets.begin() + end);
+                for (auto& thread_counts : counts) {
+                  for (Vertex vertex = begin; vertex < end; ++vertex) {
+                    size_t count = thread_counts[vertex];
+                    thread_counts[vertex] = cursors[vertex - begin];
+                    cursors[vertex - begin] += count;
+                  }
+                }
+              });
+
+  targets.resize(edges_.size());
+  ParallelFor(0, num_threads, num_threads,
+              [&](size_t begin, size_t end, size_t) {
+                for (size_t thread = begin; thread < end; ++thread) {
+                  size_t edges_end =
+                      std::min(edges_.size(), (thread + 1) * block);
+                  auto& positions = counts[thread];
+                  for (size_t i = thread * block; i < edges_end; ++i) {
+                    targets[positions[key(edges_[i])]++] = value(edges_[i]);
+                  }
+                }
+              });
+  Normalize(offsets, targets);
+}
+
+void GraphBuilder::Normalize(std::vector<size_t>& offsets,
+                             std::vector<Vertex>& targets) const {
+  if (!sort_adjacency_ && !deduplicate_) {
+    return;
+  }
+  auto degrees = std::vector<size_t>(num_vertices_ + 1, 0);
+  ParallelFor(0, num_vertices_, num_threads_,
+              [&](size_t begin, size_t end, size_t) {
+                for (Vertex vertex = begin; vertex < end; ++vertex) {
+                  auto first = targets.begin() + offsets[vertex];
+                  auto last = targets.begin() + offsets[vertex + 1];
+                  std::sort(first, last);
+                  if (deduplicate_) {
+                    last = std::unique(first, last);
+                  }
+                  degrees[vertex + 1] = last - first;
+                }
+              });
+  if (!deduplicate_) {
+    return;
+  }
+
+  for (Vertex vertex = 0; vertex < num_vertices_; ++vertex) {
+    degrees[vertex + 1] += degrees[vertex];
+  }
+  auto compacted = std::vector<Vertex>(degrees[num_vertices_]);
+  ParallelFor(0, num_vertices_, num_threads_,
+              [&](size_t begin, size_t end, size_t) {
+                for (Vertex vertex = begin; vertex < end; ++vertex) {
+                  std::copy(targets.begin() + offsets[vertex],
+                            targets.begin() + offsets[vertex] +
+                                (degrees[vertex + 1] - degrees[vertex]),
+                            compacted.begin() + degrees[vertex]);
+                }
+              });
+  offsets = std::move(degrees);
+  targets = std::move(compacted);
+}
+
+CSRGraph GraphBuilder::BuildCSRGraph() const {
+  CSRGraph graph;
+  Scatter(false, graph.next_offsets_, graph.next_targets_);
+  Scatter(true, graph.prev_offsets_, graph.prev_sources_);
+  return graph;
+}
+
+ListGraph GraphBuilder::BuildListGraph() const {
+  ListGraph graph(num_vertices_);
+  std::vector<size_t> offsets;
+  std::vector<Vertex> targets;
+  for (bool reversed : {false, true}) {
+    Scatter(reversed, offsets, targets);
+    auto& lists = reversed ? graph.prev_vertives_ : graph.next_vertices_;
+    ParallelFor(0, num_vertices_, num_threads_,
+                [&](size_t begin, size_t end, size_t) {
+                  for (Vertex vertex = begin; vertex < end; ++vertex) {
+                    lists[vertex].assign(targets.begin() + offsets[vertex],
+                                         targets.begin() + offsets[vertex + 1]);
+                  }
+                });
+  }
+  return graph;
+}
+
+SetGraph GraphBuilder::BuildSetGraph() const {
+  SetGraph graph(num_vertices_);
+  std::vector<size_t> offsets;
+  std::vector<Vertex> targets;
+  for (bool reversed : {false, true}) {
+    Scatter(reversed, offsets, targets);
+    auto& sets = reversed ? graph.prev_vertices_ : graph.next_vertices_;
+    ParallelFor(0, num_vertices_, num_threads_,
+                [&](size_t begin, size_t end, size_t) {
+                  for (Vertex vertex = begin; vertex < end; ++vertex) {
+                    for (size_t i = offsets[vertex]; i < offsets[vertex + 1];
+                         ++i) {
+                      sets[vertex].Insert(targets[i]);
+                    }
+                  }
+                });
+  }
+  return graph;
+}
+
+MatrixGraph GraphBuilder::BuildMatrixGraph() const {
+  MatrixGraph graph(num_vertices_);
+  std::vector<size_t> offsets;
+  std::vector<Vertex> targets;
+  Scatter(false, offsets, targets);
+  ParallelFor(0, num_vertices_, num_threads_,
+              [&](size_t begin, size_t end, size_t) {
+                for (Vertex from = begin; from < end; ++from) {
+                  for (size_t i = offsets[from]; i < offsets[from + 1]; ++i) {
+                    ++graph.matrix_[from][targets[i]];
+                  }
+                }
+              });
+  return graph;
+}
+
+ArcGraph GraphBuilder::BuildArcGraph() const {
+  ArcGraph graph(num_vertices_);
+  std::vector<size_t> offsets;
+  std::vector<Vertex> targets;
+  Scatter(false, offsets, targets);
+  graph.edges_.resize(targets.size());
+  ParallelFor(0, num_vertices_, num_threads_,
+              [&](size_t begin, size_t end, size_t) {
+                for (Vertex from = begin; from < end; ++from) {
+                  for (size_t i = offsets[from]; i < offsets[from + 1]; ++i) {
+                    graph.edges_[i] = std::make_pair(from, targets[i]);
+                  }
+                }
+              });
+  return graph;
+}
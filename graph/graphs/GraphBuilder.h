@@ -0,0 +1,70 @@
+#ifndef INC_1_A_GRAPHBUILDER_H
+#define INC_1_A_GRAPHBUILDER_H
+
+#include <utility>
+#include <vector>
+#include "ArcGraph.h"
+#include "CSRGraph.h"
+#include "IGraph.h"
+#include "ListGraph.h"
+#include "MatrixGraph.h"
+#include "SetGraph.h"
+
+using Edge = std::pair<Vertex, Vertex>;
+
+// Collects an edge list and turns it into any graph representation at once:
+// degrees are counted and edges scattered by a parallel counting sort, and
+// the result is written straight into the representation's storage. Edges
+// keep their input order within every adjacency list. The sort uses at most
+// E / V threads (at least one), so its per-thread degree counts never take
+// more memory than the edge targets themselves.
+class GraphBuilder {
+ public:
+  explicit GraphBuilder(size_t num_vertices);
+
+  void AddEdge(Vertex from, Vertex to) { edges_.emplace_back(from, to); }
+
+  void AddEdges(const std::vector<Edge>& edges);
+
+  void AddEdges(std::vector<Edge>&& edges);
+
+  void SetThreadsCount(size_t num_threads) { num_threads_ = num_threads; }
+
+  // Sort every adjacency list by vertex number
+  void SetSortAdjacency(bool sort_adjacency) {
+    sort_adjacency_ = sort_adjacency;
+  }
+
+  // Drop parallel edges (implies sorted adjacency)
+  void SetDeduplicate(bool deduplicate) { deduplicate_ = deduplicate; }
+
+  size_t VerticesCount() const { return num_vertices_; }
+
+  size_t EdgesCount() const { return edges_.size(); }
+
+  CSRGraph BuildCSRGraph() const;
+
+  ListGraph BuildListGraph() const;
+
+  SetGraph BuildSetGraph() const;
+
+  MatrixGraph BuildMatrixGraph() const;
+
+  ArcGraph BuildArcGraph() const;
+
+ private:
+  // Groups edges by source (or by target if reversed) into offsets/targets
+  void Scatter(bool reversed, std::vector<size_t>& offsets,
+               std::vector<Vertex>& targets) const;
+
+  void Normalize(std::vector<size_t>& offsets,
+                 std::vector<Vertex>& targets) const;
+
+  size_t num_vertices_;
+  size_t num_threads_;
+  bool sort_adjacency_;
+  bool deduplicate_;
+  std::vector<Edge> edges_;
+};
+
+#endif  // INC_1_A_GRAPHBUILDER_H
@@ -0,0 +1,150 @@
+#include "GraphFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+static_assert(sizeof(Vertex) == sizeof(uint64_t),
+              "graph files store vertices as 64-bit integers");
+
+template <typename T>
+static void WriteArray(std::ofstream& out, const std::vector<T>& array) {
+  out.write(reinterpret_cast<const char*>(array.data()),
+            array.size() * sizeof(T));
+}
+
+bool WriteGraphFile(const std::string& path, const CSRGraph& graph,
+                    const std::vector<int64_t>& weights) {
+  assert(weights.empty() || weights.size() == graph.EdgesCount());
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  GraphFileHeader header = {kGraphFileMagic, kGraphFileVersion,
+                            weights.empty() ? 0 : kGraphFileWeighted,
+                            kGraphFileByteOrder, graph.VerticesCount(),
+                            graph.EdgesCount()};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  WriteArray(out, graph.NextOffsets());
+  WriteArray(out, graph.NextTargets());
+  WriteArray(out, graph.PrevOffsets());
+  WriteArray(out, graph.PrevSources());
+  WriteArray(out, weights);
+  return static_cast<bool>(out);
+}
+
+MappedGraph::~MappedGraph() { Close(); }
+
+bool MappedGraph::Open(const std::string& path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(GraphFileHeader)) {
+    close(fd);
+    return false;
+  }
+  size_ = file_stat.st_size;
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    return false;
+  }
+
+  auto header = static_cast<const GraphFileHeader*>(data_);
+  size_t vertices = header->num_vertices;
+  size_t edges = header->num_edges;
+  bool weighted = (header->flags & kGraphFileWeighted) != 0;
+  // Bound the counts by the file size first so the expected size below
+  // cannot overflow
+  size_t words = (size_ - sizeof(GraphFileHeader)) / sizeof(uint64_t);
+  if (header->magic != kGraphFileMagic ||
+      header->version != kGraphFileVersion ||
+      header->byte_order != kGraphFileByteOrder || vertices >= words ||
+      edges > words) {
+    Close();
+    return false;
+  }
+  size_t expected_size =
+      sizeof(GraphFileHeader) +
+      sizeof(uint64_t) * (2 * (vertices + 1) + (weighted ? 3 : 2) * edges);
+  if (size_ != expected_size) {
+    Close();
+    return false;
+  }
+
+  auto arrays = reinterpret_cast<const uint64_t*>(header + 1);
+  next_offsets_ = arrays;
+  next_targets_ = next_offsets_ + vertices + 1;
+  prev_offsets_ = next_targets_ + edges;
+  prev_sources_ = prev_offsets_ + vertices + 1;
+  if (!IsWellFormed(next_offsets_, next_targets_, vertices, edges) ||
+      !IsWellFormed(prev_offsets_, prev_sources_, vertices, edges)) {
+    Close();
+    return false;
+  }
+  num_vertices_ = vertices;
+  num_edges_ = edges;
+  if (weighted) {
+    weights_ = reinterpret_cast<const int64_t*>(prev_sources_ + edges);
+  }
+  return true;
+}
+
+bool MappedGraph::IsWellFormed(const uint64_t* offsets, const Vertex* targets,
+                               size_t num_vertices, size_t num_edges) {
+  if (offsets[0] != 0 || offsets[num_vertices] != num_edges) {
+    return false;
+  }
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (offsets[vertex] > offsets[vertex + 1]) {
+      return false;
+    }
+  }
+  for (size_t edge = 0; edge < num_edges; ++edge) {
+    if (targets[edge] >= num_vertices) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MappedGraph::Close() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  num_vertices_ = 0;
+  num_edges_ = 0;
+  next_offsets_ = nullptr;
+  next_targets_ = nullptr;
+  prev_offsets_ = nullptr;
+  prev_sources_ = nullptr;
+  weights_ = nullptr;
+}
+
+void MappedGraph::AddEdge(Vertex /*from*/, Vertex /*to*/) {
+  std::fputs("MappedGraph is read-only\n", stderr);
+  std::abort();
+}
+
+void MappedGraph::GetNextVertices(Vertex vertex,
+                                  std::vector<Vertex>& vertices) const {
+  VertexSpan next = NextVertices(vertex);
+  vertices.assign(next.begin(), next.end());
+}
+
+void MappedGraph::GetPrevVertices(Vertex vertex,
+                                  std::vector<Vertex>& vertices) const {
+  VertexSpan prev = PrevVertices(vertex);
+  vertices.assign(prev.begin(), prev.end());
+}
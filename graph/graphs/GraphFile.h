@@ -0,0 +1,103 @@
+#ifndef INC_1_A_GRAPHFILE_H
+#define INC_1_A_GRAPHFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CSRGraph.h"
+#include "IGraph.h"
+
+// On-disk layout (all fields in the writer's native byte order, 8-byte
+// aligned; files are meant to be read on the machine that wrote them and
+// the byte order tag rejects the others):
+//   GraphFileHeader
+//   next offsets   [num_vertices + 1] uint64
+//   next targets   [num_edges]        uint64
+//   prev offsets   [num_vertices + 1] uint64
+//   prev sources   [num_edges]        uint64
+//   weights        [num_edges]        int64, parallel to next targets
+//                                     (present if kGraphFileWeighted is set)
+const uint32_t kGraphFileMagic = 0x46524749;  // "IGRF"
+const uint32_t kGraphFileVersion = 2;
+const uint64_t kGraphFileWeighted = 1;
+// Reads back as a different value under the other byte order
+const uint64_t kGraphFileByteOrder = 0x0102030405060708;
+
+struct GraphFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t flags;
+  uint64_t byte_order;
+  uint64_t num_vertices;
+  uint64_t num_edges;
+};
+
+// Weights are indexed like graph.NextTargets(); pass an empty vector for an
+// unweighted graph.
+bool WriteGraphFile(const std::string& path, const CSRGraph& graph,
+                    const std::vector<int64_t>& weights);
+
+// Read-only graph backed by a memory-mapped graph file: opening costs one
+// mmap call, adjacency is served straight from the page cache.
+class MappedGraph : public IGraph {
+ public:
+  MappedGraph() = default;
+
+  MappedGraph(const MappedGraph&) = delete;
+
+  MappedGraph& operator=(const MappedGraph&) = delete;
+
+  ~MappedGraph() override;
+
+  // False if the file is missing, truncated, of another version or byte
+  // order, or its adjacency arrays are malformed
+  bool Open(const std::string& path);
+
+  void Close();
+
+  // The mapping is read-only: aborts.
+  void AddEdge(Vertex from, Vertex to) override;
+
+  size_t VerticesCount() const override { return num_vertices_; }
+
+  size_t EdgesCount() const { return num_edges_; }
+
+  bool IsWeighted() const { return weights_ != nullptr; }
+
+  void GetNextVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  void GetPrevVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  VertexSpan NextVertices(Vertex vertex) const override {
+    return VertexSpan(next_targets_ + next_offsets_[vertex],
+                      next_targets_ + next_offsets_[vertex + 1]);
+  }
+
+  VertexSpan PrevVertices(Vertex vertex) const override {
+    return VertexSpan(prev_sources_ + prev_offsets_[vertex],
+                      prev_sources_ + prev_offsets_[vertex + 1]);
+  }
+
+  // Weights of the edges returned by NextVertices(vertex), in the same order
+  const int64_t* NextWeights(Vertex vertex) const {
+    return weights_ + next_offsets_[vertex];
+  }
+
+ private:
+  static bool IsWellFormed(const uint64_t* offsets, const Vertex* targets,
+                           size_t num_vertices, size_t num_edges);
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  size_t num_vertices_ = 0;
+  size_t num_edges_ = 0;
+  const uint64_t* next_offsets_ = nullptr;
+  const Vertex* next_targets_ = nullptr;
+  const uint64_t* prev_offsets_ = nullptr;
+  const Vertex* prev_sources_ = nullptr;
+  const int64_t* weights_ = nullptr;
+};
+
+#endif  // INC_1_A_GRAPHFILE_H
@@ -5,11 +5,53 @@
 #ifndef INC_1_A_IGRAPH_H
 #define INC_1_A_IGRAPH_H
 
+#include <cstddef>
+#include <memory>
+#include <utility>
 #include <vector>
 
 using std::size_t;
 using Vertex = std::size_t;
 
+// View over a contiguous run of vertices (a C++17 stand-in for
+// std::span<const Vertex>). Usually it points into the graph's own storage;
+// Owning() makes one that keeps a copy alive for as long as the span (or a
+// copy of it) exists.
+class VertexSpan {
+ public:
+  VertexSpan() : begin_(nullptr), end_(nullptr) {}
+
+  VertexSpan(const Vertex* begin, const Vertex* end)
+      : begin_(begin), end_(end) {}
+
+  VertexSpan(const std::vector<Vertex>& vertices)
+      : begin_(vertices.data()), end_(vertices.data() + vertices.size()) {}
+
+  static VertexSpan Owning(std::vector<Vertex>&& vertices) {
+    VertexSpan span;
+    span.storage_ =
+        std::make_shared<const std::vector<Vertex>>(std::move(vertices));
+    span.begin_ = span.storage_->data();
+    span.end_ = span.begin_ + span.storage_->size();
+    return span;
+  }
+
+  const Vertex* begin() const { return begin_; }
+
+  const Vertex* end() const { return end_; }
+
+  size_t size() const { return end_ - begin_; }
+
+  bool empty() const { return begin_ == end_; }
+
+  Vertex operator[](size_t index) const { return begin_[index]; }
+
+ private:
+  const Vertex* begin_;
+  const Vertex* end_;
+  std::shared_ptr<const std::vector<Vertex>> storage_;
+};
+
 struct IGraph {
  public:
   virtual ~IGraph() {}
@@ -23,6 +65,30 @@ struct IGraph {
 
   virtual void GetPrevVertices(Vertex vertex,
                                std::vector<Vertex>& vertices) const = 0;
+
+  virtual bool HasEdge(Vertex from, Vertex to) const {
+    for (auto next : NextVertices(from)) {
+      if (next == to) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Adjacency as a span. Representations that keep neighbors packed
+  // override these with zero-copy views; the rest hand out a span owning a
+  // copy, so nested calls on the same thread never overwrite each other.
+  virtual VertexSpan NextVertices(Vertex vertex) const {
+    std::vector<Vertex> vertices;
+    GetNextVertices(vertex, vertices);
+    return VertexSpan::Owning(std::move(vertices));
+  }
+
+  virtual VertexSpan PrevVertices(Vertex vertex) const {
+    std::vector<Vertex> vertices;
+    GetPrevVertices(vertex, vertices);
+    return VertexSpan::Owning(std::move(vertices));
+  }
 };
 
 #endif  // INC_1_A_IGRAPH_H
@@ -25,7 +25,17 @@ class ListGraph : public IGraph {
   void GetPrevVertices(Vertex vertex,
                        std::vector<Vertex>& vertices) const override;
 
+  VertexSpan NextVertices(Vertex vertex) const override {
+    return next_vertices_[vertex];
+  }
+
+  VertexSpan PrevVertices(Vertex vertex) const override {
+    return prev_vertives_[vertex];
+  }
+
  private:
+  friend class GraphBuilder;
+
   std::vector<std::vector<Vertex>> next_vertices_;
   std::vector<std::vector<Vertex>> prev_vertives_;
 };
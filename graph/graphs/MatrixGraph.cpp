@@ -8,11 +8,9 @@ MatrixGraph::MatrixGraph(const IGraph* graph) {
   size_t num_vertices = graph->VerticesCount();
   matrix_ = std::vector<std::vector<int>>(num_vertices,
                                           std::vector<int>(num_vertices, 0));
-  auto temp = std::vector<Vertex>();
-  for (int i = 0; i < num_vertices; ++i) {
-    graph->GetNextVertices(i, temp);
-    for (int j = 0; j < temp.size(); ++i) {
-      ++matrix_[i][j];
+  for (Vertex from = 0; from < num_vertices; ++from) {
+    for (auto to : graph->NextVertices(from)) {
+      ++matrix_[from][to];
     }
   }
 }
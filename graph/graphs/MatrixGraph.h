@@ -19,6 +19,10 @@ class MatrixGraph : public IGraph {
 
   size_t VerticesCount() const override { return matrix_.size(); }
 
+  bool HasEdge(Vertex from, Vertex to) const override {
+    return matrix_[from][to] != 0;
+  }
+
   void GetNextVertices(Vertex vertex,
                        std::vector<Vertex>& vertices) const override;
 
@@ -26,6 +30,8 @@ class MatrixGraph : public IGraph {
                        std::vector<Vertex>& vertices) const override;
 
  private:
+  friend class GraphBuilder;
+
   std::vector<std::vector<int>> matrix_;
 };
 
@@ -0,0 +1,73 @@
+#ifndef INC_1_A_PARALLEL_H
+#define INC_1_A_PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+inline size_t DefaultThreadsCount() {
+  size_t num_threads = std::thread::hardware_concurrency();
+  return num_threads == 0 ? 1 : num_threads;
+}
+
+// Splits [begin, end) into contiguous blocks, one per thread, and calls
+// body(block_begin, block_end, thread_index) for each of them.
+template <typename Body>
+void ParallelFor(size_t begin, size_t end, size_t num_threads, Body body) {
+  if (begin >= end) {
+    return;
+  }
+  num_threads = std::max<size_t>(1, std::min(num_threads, end - begin));
+  if (num_threads == 1) {
+    body(begin, end, 0);
+    return;
+  }
+  size_t block = (end - begin + num_threads - 1) / num_threads;
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < num_threads; ++thread) {
+    size_t block_begin = std::min(end, begin + thread * block);
+    size_t block_end = std::min(end, block_begin + block);
+    threads.emplace_back(body, block_begin, block_end, thread);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Sorts one block per thread, then merges neighbouring sorted runs in
+// pairs, every pair of a round on its own thread, until one run is left.
+template <typename Iterator, typename Compare>
+void ParallelSort(Iterator begin, Iterator end, Compare compare,
+                  size_t num_threads) {
+  const size_t kMinBlock = 4096;
+  size_t size = end - begin;
+  num_threads = std::max<size_t>(1, std::min(num_threads, size / kMinBlock));
+  if (num_threads == 1) {
+    std::sort(begin, end, compare);
+    return;
+  }
+  size_t block = (size + num_threads - 1) / num_threads;
+  ParallelFor(0, num_threads, num_threads,
+              [&](size_t first, size_t last, size_t) {
+                for (size_t run = first; run < last; ++run) {
+                  std::sort(begin + std::min(size, run * block),
+                            begin + std::min(size, (run + 1) * block),
+                            compare);
+                }
+              });
+  for (size_t width = block; width < size; width *= 2) {
+    size_t pairs = (size + 2 * width - 1) / (2 * width);
+    ParallelFor(0, pairs, num_threads,
+                [&](size_t first, size_t last, size_t) {
+                  for (size_t pair = first; pair < last; ++pair) {
+                    size_t left = pair * 2 * width;
+                    size_t middle = std::min(size, left + width);
+                    size_t right = std::min(size, left + 2 * width);
+                    std::inplace_merge(begin + left, begin + middle,
+                                       begin + right, compare);
+                  }
+                });
+  }
+}
+
+#endif  // INC_1_A_PARALLEL_H
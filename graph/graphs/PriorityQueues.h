@@ -0,0 +1,210 @@
+#ifndef INC_1_A_PRIORITYQUEUES_H
+#define INC_1_A_PRIORITYQUEUES_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "IGraph.h"
+
+// Min-priority queues over vertices for label-setting searches. All of them
+// share one interface:
+//   Queue(num_vertices)
+//   Update(vertex, key)  insert, or lower the key of a queued vertex
+//   Pop()                remove a (vertex, key) pair with the least key
+//   Empty(), Clear()
+// Queues without decrease-key (IsLazy) keep stale entries, so the caller
+// must skip popped pairs whose key is above the vertex's current label.
+
+// d-ary heap with a position index, so Update is a real decrease-key
+template <typename Key, size_t Arity = 4>
+class IndexedDaryHeap {
+ public:
+  static constexpr bool IsLazy = false;
+
+  explicit IndexedDaryHeap(size_t num_vertices)
+      : position_(num_vertices, kAbsent) {}
+
+  bool Empty() const { return heap_.empty(); }
+
+  bool Contains(Vertex vertex) const { return position_[vertex] != kAbsent; }
+
+  // Least key; the heap must not be empty
+  Key MinKey() const { return heap_.front().first; }
+
+  void Update(Vertex vertex, Key key) {
+    if (!Contains(vertex)) {
+      position_[vertex] = heap_.size();
+      heap_.emplace_back(key, vertex);
+    } else {
+      assert(key <= heap_[position_[vertex]].first);
+      heap_[position_[vertex]].first = key;
+    }
+    SiftUp(position_[vertex]);
+  }
+
+  std::pair<Vertex, Key> Pop() {
+    auto [key, vertex] = heap_.front();
+    position_[vertex] = kAbsent;
+    if (heap_.size() > 1) {
+      heap_.front() = heap_.back();
+      position_[heap_.front().second] = 0;
+      heap_.pop_back();
+      SiftDown(0);
+    } else {
+      heap_.pop_back();
+    }
+    return std::make_pair(vertex, key);
+  }
+
+  void Clear() {
+    for (auto [key, vertex] : heap_) {
+      position_[vertex] = kAbsent;
+    }
+    heap_.clear();
+  }
+
+ private:
+  static constexpr size_t kAbsent = std::numeric_limits<size_t>::max();
+
+  void Place(size_t index, std::pair<Key, Vertex> entry) {
+    heap_[index] = entry;
+    position_[entry.second] = index;
+  }
+
+  void SiftUp(size_t index) {
+    auto entry = heap_[index];
+    while (index > 0) {
+      size_t parent = (index - 1) / Arity;
+      if (!(entry.first < heap_[parent].first)) {
+        break;
+      }
+      Place(index, heap_[parent]);
+      index = parent;
+    }
+    Place(index, entry);
+  }
+
+  void SiftDown(size_t index) {
+    auto entry = heap_[index];
+    while (true) {
+      size_t first_child = index * Arity + 1;
+      if (first_child >= heap_.size()) {
+        break;
+      }
+      size_t last_child = std::min(heap_.size(), first_child + Arity);
+      size_t best = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (heap_[child].first < heap_[best].first) {
+          best = child;
+        }
+      }
+      if (!(heap_[best].first < entry.first)) {
+        break;
+      }
+      Place(index, heap_[best]);
+      index = best;
+    }
+    Place(index, entry);
+  }
+
+  std::vector<std::pair<Key, Vertex>> heap_;
+  std::vector<size_t> position_;
+};
+
+// Monotone radix heap for unsigned integer keys: popped keys never
+// decrease, and every entry moves between buckets at most once per bit
+template <typename Key>
+class RadixHeap {
+ public:
+  static constexpr bool IsLazy = true;
+
+  explicit RadixHeap(size_t /*num_vertices*/) : last_(0), size_(0) {}
+
+  bool Empty() const { return size_ == 0; }
+
+  void Update(Vertex vertex, Key key) {
+    assert(key >= last_);
+    buckets_[Bucket(key)].emplace_back(key, vertex);
+    ++size_;
+  }
+
+  std::pair<Vertex, Key> Pop() {
+    if (buckets_[0].empty()) {
+      size_t bucket = 1;
+      while (buckets_[bucket].empty()) {
+        ++bucket;
+      }
+      last_ = buckets_[bucket].front().first;
+      for (const auto& entry : buckets_[bucket]) {
+        last_ = std::min(last_, entry.first);
+      }
+      for (const auto& entry : buckets_[bucket]) {
+        buckets_[Bucket(entry.first)].push_back(entry);
+      }
+      buckets_[bucket].clear();
+    }
+    auto [key, vertex] = buckets_[0].back();
+    buckets_[0].pop_back();
+    --size_;
+    return std::make_pair(vertex, key);
+  }
+
+  void Clear() {
+    for (auto& bucket : buckets_) {
+      bucket.clear();
+    }
+    last_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  static_assert(std::is_unsigned<Key>::value,
+                "RadixHeap needs unsigned integer keys");
+  static constexpr size_t kBits = std::numeric_limits<Key>::digits;
+
+  size_t Bucket(Key key) const {
+    return key == last_
+               ? 0
+               : 64 - __builtin_clzll(static_cast<uint64_t>(key ^ last_));
+  }
+
+  std::vector<std::pair<Key, Vertex>> buckets_[kBits + 1];
+  Key last_;
+  size_t size_;
+};
+
+// Plain binary heap; decrease-key pushes a duplicate
+template <typename Key>
+class LazyBinaryHeap {
+ public:
+  static constexpr bool IsLazy = true;
+
+  explicit LazyBinaryHeap(size_t /*num_vertices*/) {}
+
+  bool Empty() const { return heap_.empty(); }
+
+  void Update(Vertex vertex, Key key) { heap_.emplace(key, vertex); }
+
+  std::pair<Vertex, Key> Pop() {
+    auto [key, vertex] = heap_.top();
+    heap_.pop();
+    return std::make_pair(vertex, key);
+  }
+
+  void Clear() { heap_ = Heap(); }
+
+ private:
+  using Heap = std::priority_queue<std::pair<Key, Vertex>,
+                                   std::vector<std::pair<Key, Vertex>>,
+                                   std::greater<std::pair<Key, Vertex>>>;
+
+  Heap heap_;
+};
+
+#endif  // INC_1_A_PRIORITYQUEUES_H
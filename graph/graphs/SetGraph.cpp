@@ -4,32 +4,42 @@
 
 #include "SetGraph.h"
 
-SetGraph::SetGraph(const IGraph *graph) {
-  size_t num_vertices = graph->VerticesCount();
-  for (int i = 0; i < num_vertices; ++i) {
-    auto temp = std::vector<Vertex>();
-    graph->GetNextVertices(i, temp);
-    next_vertices_[i] =
-        std::unordered_multiset<Vertex>(temp.begin(), temp.end());
-    graph->GetPrevVertices(i, temp);
-    prev_vertices_[i] =
-        std::unordered_multiset<Vertex>(temp.begin(), temp.end());
+SetGraph::SetGraph(const IGraph *graph)
+    : next_vertices_(graph->VerticesCount()),
+      prev_vertices_(graph->VerticesCount()) {
+  for (Vertex from = 0; from < VerticesCount(); ++from) {
+    for (auto to : graph->NextVertices(from)) {
+      next_vertices_[from].Insert(to);
+      prev_vertices_[to].Insert(from);
+    }
   }
 }
 
 void SetGraph::AddEdge(Vertex from, Vertex to) {
-  next_vertices_[from].insert(to);
-  prev_vertices_[to].insert(from);
+  next_vertices_[from].Insert(to);
+  prev_vertices_[to].Insert(from);
+}
+
+bool SetGraph::RemoveEdge(Vertex from, Vertex to) {
+  if (!next_vertices_[from].Erase(to)) {
+    return false;
+  }
+  prev_vertices_[to].Erase(from);
+  return true;
 }
 
 void SetGraph::GetNextVertices(Vertex vertex,
                                std::vector<Vertex> &vertices) const {
-  vertices = std::vector<Vertex>(next_vertices_[vertex].begin(),
-                                 next_vertices_[vertex].end());
+  vertices.clear();
+  vertices.reserve(next_vertices_[vertex].Size());
+  next_vertices_[vertex].ForEach(
+      [&](Vertex next) { vertices.emplace_back(next); });
 }
 
 void SetGraph::GetPrevVertices(Vertex vertex,
                                std::vector<Vertex> &vertices) const {
-  vertices = std::vector<Vertex>(prev_vertices_[vertex].begin(),
-                                 prev_vertices_[vertex].end());
+  vertices.clear();
+  vertices.reserve(prev_vertices_[vertex].Size());
+  prev_vertices_[vertex].ForEach(
+      [&](Vertex prev) { vertices.emplace_back(prev); });
 }
@@ -5,29 +5,43 @@
 #ifndef INC_1_A_SETGRAPH_H
 #define INC_1_A_SETGRAPH_H
 
-#include <unordered_set>
 #include <vector>
+#include "FlatVertexSet.h"
 #include "IGraph.h"
 
 class SetGraph : public IGraph {
  public:
   explicit SetGraph(size_t num_vertices)
-      : next_vertices_(num_vertices, std::unordered_multiset<Vertex>()),
-        prev_vertices_(num_vertices, std::unordered_multiset<Vertex>()) {}
+      : next_vertices_(num_vertices), prev_vertices_(num_vertices) {}
 
   explicit SetGraph(const IGraph* graph);
 
   void AddEdge(Vertex from, Vertex to) override;
 
-  size_t VerticesCount() { return next_vertices_.size(); }
+  // Removes one copy of the edge; returns false if there was none
+  bool RemoveEdge(Vertex from, Vertex to);
 
-  void GetNextVertices(Vertex vertex, std::vector<Vertex>& vertices) const;
+  bool HasEdge(Vertex from, Vertex to) const override {
+    return next_vertices_[from].Contains(to);
+  }
 
-  void GetPrevVertices(Vertex vertex, std::vector<Vertex>& vertices) const;
+  size_t EdgeMultiplicity(Vertex from, Vertex to) const {
+    return next_vertices_[from].Count(to);
+  }
+
+  size_t VerticesCount() const override { return next_vertices_.size(); }
+
+  void GetNextVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
+
+  void GetPrevVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override;
 
  private:
-  std::vector<std::unordered_multiset<Vertex>> next_vertices_;
-  std::vector<std::unordered_multiset<Vertex>> prev_vertices_;
+  friend class GraphBuilder;
+
+  std::vector<FlatVertexMultiset> next_vertices_;
+  std::vector<FlatVertexMultiset> prev_vertices_;
 };
 
 #endif  // INC_1_A_SETGRAPH_H
@@ -0,0 +1,327 @@
+#include "StronglyConnectedComponents.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <queue>
+#include "BreadthFirstSearch.h"
+#include "GraphBuilder.h"
+#include "TransposedGraph.h"
+
+namespace {
+
+const size_t kNoComponent = std::numeric_limits<size_t>::max();
+
+// Component ids in the order Tarjan emits them (sinks first)
+size_t TarjanComponents(const CSRGraph& graph, std::vector<size_t>& component) {
+  size_t num_vertices = graph.VerticesCount();
+  auto index = std::vector<size_t>(num_vertices, kNoComponent);
+  auto low = std::vector<size_t>(num_vertices, 0);
+  auto on_stack = std::vector<bool>(num_vertices, false);
+  // Explicit call stack of (vertex, next edge to look at)
+  std::vector<std::pair<Vertex, size_t>> calls;
+  std::vector<Vertex> stack;
+  size_t counter = 0;
+  size_t num_components = 0;
+
+  for (Vertex start = 0; start < num_vertices; ++start) {
+    if (index[start] != kNoComponent) {
+      continue;
+    }
+    calls.emplace_back(start, 0);
+    index[start] = low[start] = counter++;
+    stack.push_back(start);
+    on_stack[start] = true;
+    while (!calls.empty()) {
+      auto& [vertex, position] = calls.back();
+      VertexSpan next = graph.NextVertices(vertex);
+      if (position < next.size()) {
+        Vertex child = next[position++];
+        if (index[child] == kNoComponent) {
+          index[child] = low[child] = counter++;
+          stack.push_back(child);
+          on_stack[child] = true;
+          calls.emplace_back(child, 0);
+        } else if (on_stack[child]) {
+          low[vertex] = std::min(low[vertex], index[child]);
+        }
+        continue;
+      }
+      Vertex finished = vertex;
+      calls.pop_back();
+      if (!calls.empty()) {
+        Vertex parent = calls.back().first;
+        low[parent] = std::min(low[parent], low[finished]);
+      }
+      if (low[finished] == index[finished]) {
+        Vertex member = kNoVertex;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          on_stack[member] = false;
+          component[member] = num_components;
+        } while (member != finished);
+        ++num_components;
+      }
+    }
+  }
+  return num_components;
+}
+
+class ForwardBackwardSolver {
+ public:
+  ForwardBackwardSolver(const CSRGraph& graph, size_t num_threads)
+      : graph_(graph),
+        num_threads_(num_threads),
+        component_(graph.VerticesCount()),
+        num_components_(0) {
+    for (auto& id : component_) {
+      id.store(kNoComponent, std::memory_order_relaxed);
+    }
+  }
+
+  size_t Run(std::vector<size_t>& component) {
+    Trim();
+    ForwardBackward();
+    while (Coloring()) {
+    }
+    for (Vertex vertex = 0; vertex < component.size(); ++vertex) {
+      component[vertex] = component_[vertex].load(std::memory_order_relaxed);
+    }
+    return num_components_;
+  }
+
+ private:
+  bool IsFree(Vertex vertex) const {
+    return component_[vertex].load(std::memory_order_relaxed) == kNoComponent;
+  }
+
+  size_t NewComponent() { return num_components_.fetch_add(1); }
+
+  bool HasFreeNeighbor(VertexSpan neighbors) const {
+    for (auto neighbor : neighbors) {
+      if (IsFree(neighbor)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Vertices with no free predecessors or successors are components alone
+  void Trim() {
+    std::atomic<bool> changed(true);
+    while (changed) {
+      changed = false;
+      ParallelFor(0, graph_.VerticesCount(), num_threads_,
+                  [&](size_t begin, size_t end, size_t) {
+                    for (Vertex vertex = begin; vertex < end; ++vertex) {
+                      if (IsFree(vertex) &&
+                          (!HasFreeNeighbor(graph_.NextVertices(vertex)) ||
+                           !HasFreeNeighbor(graph_.PrevVertices(vertex)))) {
+                        component_[vertex].store(NewComponent(),
+                                                 std::memory_order_relaxed);
+                        changed = true;
+                      }
+                    }
+                  });
+    }
+  }
+
+  // The giant component is the intersection of what the best-connected
+  // vertex reaches forward and backward
+  void ForwardBackward() {
+    Vertex pivot = kNoVertex;
+    size_t best = 0;
+    for (Vertex vertex = 0; vertex < graph_.VerticesCount(); ++vertex) {
+      size_t score = graph_.NextVertices(vertex).size() *
+                     graph_.PrevVertices(vertex).size();
+      if (IsFree(vertex) && (pivot == kNoVertex || score > best)) {
+        pivot = vertex;
+        best = score;
+      }
+    }
+    if (pivot == kNoVertex) {
+      return;
+    }
+    BFSOptions options;
+    options.num_threads = num_threads_;
+    options.edge_filter = [this](Vertex, Vertex to) { return IsFree(to); };
+    auto forward = BreadthFirstSearch(graph_, options).Run(pivot);
+    TransposedGraph transposed(graph_);
+    auto backward = BreadthFirstSearch(transposed, options).Run(pivot);
+    size_t id = NewComponent();
+    ParallelFor(0, graph_.VerticesCount(), num_threads_,
+                [&](size_t begin, size_t end, size_t) {
+                  for (Vertex vertex = begin; vertex < end; ++vertex) {
+                    if (forward.levels[vertex] != kUnreached &&
+                        backward.levels[vertex] != kUnreached) {
+                      component_[vertex].store(id, std::memory_order_relaxed);
+                    }
+                  }
+                });
+  }
+
+  // Propagates the largest vertex number forward; each vertex keeping its
+  // own number roots a component made of what reaches it backward inside
+  // its color. Returns false once every vertex is assigned.
+  bool Coloring() {
+    size_t num_vertices = graph_.VerticesCount();
+    auto colors = std::vector<std::atomic<Vertex>>(num_vertices);
+    bool any_free = false;
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      colors[vertex].store(vertex, std::memory_order_relaxed);
+      any_free = any_free || IsFree(vertex);
+    }
+    if (!any_free) {
+      return false;
+    }
+
+    std::atomic<bool> changed(true);
+    while (changed) {
+      changed = false;
+      ParallelFor(
+          0, num_vertices, num_threads_,
+          [&](size_t begin, size_t end, size_t) {
+            for (Vertex vertex = begin; vertex < end; ++vertex) {
+              if (!IsFree(vertex)) {
+                continue;
+              }
+              Vertex color = colors[vertex].load(std::memory_order_relaxed);
+              for (auto next : graph_.NextVertices(vertex)) {
+                if (!IsFree(next)) {
+                  continue;
+                }
+                Vertex current = colors[next].load(std::memory_order_relaxed);
+                while (current < color &&
+                       !colors[next].compare_exchange_weak(
+                           current, color, std::memory_order_relaxed)) {
+                }
+                if (current < color) {
+                  changed = true;
+                }
+              }
+            }
+          });
+    }
+
+    std::vector<Vertex> roots;
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (IsFree(vertex) &&
+          colors[vertex].load(std::memory_order_relaxed) == vertex) {
+        roots.push_back(vertex);
+      }
+    }
+    // Colors are disjoint, so roots can be expanded independently
+    ParallelFor(0, roots.size(), num_threads_,
+                [&](size_t begin, size_t end, size_t) {
+                  std::vector<Vertex> queue;
+                  for (size_t i = begin; i < end; ++i) {
+                    Vertex root = roots[i];
+                    size_t id = NewComponent();
+                    component_[root].store(id, std::memory_order_relaxed);
+                    queue.assign(1, root);
+                    while (!queue.empty()) {
+                      Vertex current = queue.back();
+                      queue.pop_back();
+                      for (auto prev : graph_.PrevVertices(current)) {
+                        if (IsFree(prev) &&
+                            colors[prev].load(std::memory_order_relaxed) ==
+                                root) {
+                          component_[prev].store(id,
+                                                 std::memory_order_relaxed);
+                          queue.push_back(prev);
+                        }
+                      }
+                    }
+                  }
+                });
+    return true;
+  }
+
+  const CSRGraph& graph_;
+  size_t num_threads_;
+  std::vector<std::atomic<size_t>> component_;
+  std::atomic<size_t> num_components_;
+};
+
+}  // namespace
+
+SCCResult FindStronglyConnectedComponents(const IGraph& graph,
+                                          SCCAlgorithm algorithm,
+                                          size_t num_threads) {
+  // Packed adjacency gives stable spans for the iterative traversals
+  const CSRGraph* csr = dynamic_cast<const CSRGraph*>(&graph);
+  std::unique_ptr<CSRGraph> copy;
+  if (csr == nullptr) {
+    copy = std::make_unique<CSRGraph>(&graph);
+    csr = copy.get();
+  }
+  size_t num_vertices = csr->VerticesCount();
+  auto component = std::vector<size_t>(num_vertices, kNoComponent);
+  size_t num_components =
+      algorithm == SCCAlgorithm::Tarjan
+          ? TarjanComponents(*csr, component)
+          : ForwardBackwardSolver(*csr, num_threads).Run(component);
+
+  GraphBuilder builder(num_components);
+  builder.SetThreadsCount(num_threads);
+  builder.SetDeduplicate(true);
+  for (Vertex from = 0; from < num_vertices; ++from) {
+    for (auto to : csr->NextVertices(from)) {
+      if (component[from] != component[to]) {
+        builder.AddEdge(component[from], component[to]);
+      }
+    }
+  }
+  CSRGraph condensation = builder.BuildCSRGraph();
+
+  // Renumber components in topological order (Kahn)
+  auto in_degree = std::vector<size_t>(num_components, 0);
+  for (size_t id = 0; id < num_components; ++id) {
+    in_degree[id] = condensation.PrevVertices(id).size();
+  }
+  std::vector<size_t> order;
+  order.reserve(num_components);
+  for (size_t id = 0; id < num_components; ++id) {
+    if (in_degree[id] == 0) {
+      order.push_back(id);
+    }
+  }
+  for (size_t i = 0; i < order.size(); ++i) {
+    for (auto next : condensation.NextVertices(order[i])) {
+      if (--in_degree[next] == 0) {
+        order.push_back(next);
+      }
+    }
+  }
+  auto renumber = std::vector<size_t>(num_components);
+  for (size_t position = 0; position < num_components; ++position) {
+    renumber[order[position]] = position;
+  }
+
+  GraphBuilder dag_builder(num_components);
+  dag_builder.SetThreadsCount(num_threads);
+  dag_builder.SetSortAdjacency(true);
+  for (size_t id = 0; id < num_components; ++id) {
+    for (auto next : condensation.NextVertices(id)) {
+      dag_builder.AddEdge(renumber[id], renumber[next]);
+    }
+  }
+
+  auto component_offsets = std::vector<size_t>(num_components + 1, 0);
+  for (auto& id : component) {
+    id = renumber[id];
+    ++component_offsets[id + 1];
+  }
+  for (size_t id = 0; id < num_components; ++id) {
+    component_offsets[id + 1] += component_offsets[id];
+  }
+  auto component_vertices = std::vector<Vertex>(num_vertices);
+  auto position = std::vector<size_t>(component_offsets.begin(),
+                                      component_offsets.end() - 1);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    component_vertices[position[component[vertex]]++] = vertex;
+  }
+  return SCCResult(std::move(component), std::move(component_offsets),
+                   std::move(component_vertices),
+                   dag_builder.BuildCSRGraph());
+}
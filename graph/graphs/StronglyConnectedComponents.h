@@ -0,0 +1,45 @@
+#ifndef INC_1_A_STRONGLYCONNECTEDCOMPONENTS_H
+#define INC_1_A_STRONGLYCONNECTEDCOMPONENTS_H
+
+#include <vector>
+#include "CSRGraph.h"
+#include "IGraph.h"
+#include "Parallel.h"
+
+enum class SCCAlgorithm {
+  // Iterative Tarjan, single thread
+  Tarjan,
+  // Trimming, forward-backward reachability for the giant component and
+  // label propagation (coloring) for the rest, multithreaded
+  ForwardBackward
+};
+
+struct SCCResult {
+  SCCResult(std::vector<size_t>&& component,
+            std::vector<size_t>&& component_offsets,
+            std::vector<Vertex>&& component_vertices, CSRGraph&& condensation)
+      : component(std::move(component)),
+        component_offsets(std::move(component_offsets)),
+        component_vertices(std::move(component_vertices)),
+        condensation(std::move(condensation)) {}
+
+  size_t ComponentsCount() const { return component_offsets.size() - 1; }
+
+  VertexSpan ComponentVertices(size_t id) const {
+    return VertexSpan(component_vertices.data() + component_offsets[id],
+                      component_vertices.data() + component_offsets[id + 1]);
+  }
+
+  // Component ids follow a topological order of the condensation
+  std::vector<size_t> component;
+  std::vector<size_t> component_offsets;
+  std::vector<Vertex> component_vertices;
+  // One vertex per component, one edge per connected pair of components
+  CSRGraph condensation;
+};
+
+SCCResult FindStronglyConnectedComponents(
+    const IGraph& graph, SCCAlgorithm algorithm = SCCAlgorithm::Tarjan,
+    size_t num_threads = DefaultThreadsCount());
+
+#endif  // INC_1_A_STRONGLYCONNECTEDCOMPONENTS_H
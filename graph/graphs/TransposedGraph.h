@@ -0,0 +1,44 @@
+#ifndef INC_1_A_TRANSPOSEDGRAPH_H
+#define INC_1_A_TRANSPOSEDGRAPH_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "IGraph.h"
+
+// Read-only view of a graph with every edge reversed
+class TransposedGraph : public IGraph {
+ public:
+  explicit TransposedGraph(const IGraph& graph) : graph_(graph) {}
+
+  // A view cannot grow: aborts
+  void AddEdge(Vertex /*from*/, Vertex /*to*/) override {
+    std::fputs("TransposedGraph is a read-only view\n", stderr);
+    std::abort();
+  }
+
+  size_t VerticesCount() const override { return graph_.VerticesCount(); }
+
+  void GetNextVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override {
+    graph_.GetPrevVertices(vertex, vertices);
+  }
+
+  void GetPrevVertices(Vertex vertex,
+                       std::vector<Vertex>& vertices) const override {
+    graph_.GetNextVertices(vertex, vertices);
+  }
+
+  VertexSpan NextVertices(Vertex vertex) const override {
+    return graph_.PrevVertices(vertex);
+  }
+
+  VertexSpan PrevVertices(Vertex vertex) const override {
+    return graph_.NextVertices(vertex);
+  }
+
+ private:
+  const IGraph& graph_;
+};
+
+#endif  // INC_1_A_TRANSPOSEDGRAPH_H
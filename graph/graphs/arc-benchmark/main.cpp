@@ -0,0 +1,89 @@
+// Compares neighbor queries on the indexed ArcGraph against ListGraph.
+//
+// Usage: arc-benchmark [num_vertices] [num_edges] [num_batches]
+// Edges are appended in num_batches batches with a full BFS after each one,
+// which is the pattern that makes the ArcGraph index rebuild incrementally.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <vector>
+#include "../ArcGraph.h"
+#include "../ListGraph.h"
+
+using Clock = std::chrono::steady_clock;
+
+size_t BreadthFirstSearch(const IGraph& graph) {
+  auto visited = std::vector<bool>(graph.VerticesCount(), false);
+  size_t checksum = 0;
+  for (Vertex start = 0; start < graph.VerticesCount(); ++start) {
+    if (visited[start]) {
+      continue;
+    }
+    std::queue<Vertex> queue;
+    queue.push(start);
+    visited[start] = true;
+    while (!queue.empty()) {
+      Vertex current = queue.front();
+      queue.pop();
+      checksum += current;
+      for (auto next : graph.NextVertices(current)) {
+        if (!visited[next]) {
+          visited[next] = true;
+          queue.push(next);
+        }
+      }
+    }
+  }
+  return checksum;
+}
+
+template <typename Graph>
+double Run(Graph& graph, const std::vector<std::pair<Vertex, Vertex>>& edges,
+           size_t num_batches, size_t& checksum) {
+  auto start = Clock::now();
+  size_t batch = (edges.size() + num_batches - 1) / num_batches;
+  for (size_t begin = 0; begin < edges.size(); begin += batch) {
+    size_t end = std::min(edges.size(), begin + batch);
+    for (size_t i = begin; i < end; ++i) {
+      graph.AddEdge(edges[i].first, edges[i].second);
+    }
+    checksum += BreadthFirstSearch(graph);
+  }
+  // Point lookups in both directions
+  for (Vertex vertex = 0; vertex < graph.VerticesCount(); ++vertex) {
+    checksum += graph.NextVertices(vertex).size();
+    checksum += graph.PrevVertices(vertex).size();
+  }
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  size_t num_vertices = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+  size_t num_edges = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+  size_t num_batches = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 10;
+
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<Vertex> distribution(0, num_vertices - 1);
+  auto edges = std::vector<std::pair<Vertex, Vertex>>(num_edges);
+  for (auto& edge : edges) {
+    edge = std::make_pair(distribution(generator), distribution(generator));
+  }
+
+  size_t list_checksum = 0;
+  size_t arc_checksum = 0;
+  ListGraph list_graph(num_vertices);
+  ArcGraph arc_graph(num_vertices);
+  double list_time = Run(list_graph, edges, num_batches, list_checksum);
+  double arc_time = Run(arc_graph, edges, num_batches, arc_checksum);
+
+  std::cout << "ListGraph: " << list_time << " s" << std::endl;
+  std::cout << "ArcGraph:  " << arc_time << " s" << std::endl;
+  if (list_checksum != arc_checksum) {
+    std::cout << "Checksum mismatch" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,379 @@
+// Benchmark suite for the IGraph representations in graph/graphs.
+//
+// Usage: benchmark [--vertices N] [--degree D] [--queries Q]
+//                  [--generators er,powerlaw,grid,road] [--max-dense N]
+//
+// For every generated graph and representation it measures construction
+// time, heap footprint, BFS/DFS throughput and neighbor query latency
+// percentiles, then the cost of converting between every pair of
+// representations. Results go to stdout as CSV rows
+//   generator,vertices,edges,representation,metric,value
+// so runs of different versions can be diffed or plotted directly.
+// Dense representations are skipped above --max-dense vertices.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stack>
+#include <string>
+#include <vector>
+#include "../ArcGraph.h"
+#include "../CSRGraph.h"
+#include "../GraphBuilder.h"
+#include "../ListGraph.h"
+#include "../MatrixGraph.h"
+#include "../SetGraph.h"
+
+// Count live heap bytes through the global allocator
+static std::atomic<size_t> live_bytes(0);
+static const size_t kAllocationHeader = 16;
+
+void* operator new(size_t size) {
+  void* memory = std::malloc(size + kAllocationHeader);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  *static_cast<size_t*>(memory) = size;
+  live_bytes += size;
+  return static_cast<char*>(memory) + kAllocationHeader;
+}
+
+void operator delete(void* pointer) noexcept {
+  if (pointer == nullptr) {
+    return;
+  }
+  auto memory = reinterpret_cast<void*>(
+      reinterpret_cast<uintptr_t>(pointer) - kAllocationHeader);
+  live_bytes -= *static_cast<size_t*>(memory);
+  std::free(memory);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  operator delete(pointer);
+}
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct GeneratedGraph {
+  std::string name;
+  size_t num_vertices;
+  std::vector<Edge> edges;
+};
+
+void AddUndirected(std::vector<Edge>& edges, Vertex from, Vertex to) {
+  edges.emplace_back(from, to);
+  edges.emplace_back(to, from);
+}
+
+GeneratedGraph ErdosRenyi(size_t num_vertices, size_t degree,
+                          std::mt19937_64& generator) {
+  GeneratedGraph graph = {"er", num_vertices, {}};
+  std::uniform_int_distribution<Vertex> vertex(0, num_vertices - 1);
+  for (size_t i = 0; i < num_vertices * degree / 2; ++i) {
+    AddUndirected(graph.edges, vertex(generator), vertex(generator));
+  }
+  return graph;
+}
+
+// Chung-Lu model with a degree exponent of about 2.5
+GeneratedGraph PowerLaw(size_t num_vertices, size_t degree,
+                        std::mt19937_64& generator) {
+  GeneratedGraph graph = {"powerlaw", num_vertices, {}};
+  const double exponent = 2.5;
+  auto weights = std::vector<double>(num_vertices);
+  for (size_t i = 0; i < num_vertices; ++i) {
+    weights[i] = std::pow(i + 1.0, -1.0 / (exponent - 1));
+  }
+  std::discrete_distribution<Vertex> vertex(weights.begin(), weights.end());
+  for (size_t i = 0; i < num_vertices * degree / 2; ++i) {
+    AddUndirected(graph.edges, vertex(generator), vertex(generator));
+  }
+  return graph;
+}
+
+GeneratedGraph Grid(size_t num_vertices) {
+  size_t side = std::max<size_t>(1, std::sqrt(num_vertices));
+  GeneratedGraph graph = {"grid", side * side, {}};
+  for (size_t row = 0; row < side; ++row) {
+    for (size_t column = 0; column < side; ++column) {
+      Vertex vertex = row * side + column;
+      if (column + 1 < side) {
+        AddUndirected(graph.edges, vertex, vertex + 1);
+      }
+      if (row + 1 < side) {
+        AddUndirected(graph.edges, vertex, vertex + side);
+      }
+    }
+  }
+  return graph;
+}
+
+// Grid with a fifth of the streets missing and occasional diagonals, which
+// keeps the low degree and large diameter of road networks
+GeneratedGraph RoadLike(size_t num_vertices, std::mt19937_64& generator) {
+  size_t side = std::max<size_t>(1, std::sqrt(num_vertices));
+  GeneratedGraph graph = {"road", side * side, {}};
+  std::bernoulli_distribution keep(0.8);
+  std::bernoulli_distribution diagonal(0.05);
+  for (size_t row = 0; row < side; ++row) {
+    for (size_t column = 0; column < side; ++column) {
+      Vertex vertex = row * side + column;
+      if (column + 1 < side && keep(generator)) {
+        AddUndirected(graph.edges, vertex, vertex + 1);
+      }
+      if (row + 1 < side && keep(generator)) {
+        AddUndirected(graph.edges, vertex, vertex + side);
+      }
+      if (row + 1 < side && column + 1 < side && diagonal(generator)) {
+        AddUndirected(graph.edges, vertex, vertex + side + 1);
+      }
+    }
+  }
+  return graph;
+}
+
+struct Representation {
+  std::string name;
+  bool dense;
+  std::function<std::unique_ptr<IGraph>(const GeneratedGraph&)> build;
+  std::function<std::unique_ptr<IGraph>(const IGraph*)> convert;
+};
+
+template <typename Graph>
+Representation MutableRepresentation(const std::string& name, bool dense) {
+  return {name, dense,
+          [](const GeneratedGraph& generated) -> std::unique_ptr<IGraph> {
+            auto graph = std::make_unique<Graph>(generated.num_vertices);
+            for (auto [from, to] : generated.edges) {
+              graph->AddEdge(from, to);
+            }
+            return graph;
+          },
+          [](const IGraph* graph) -> std::unique_ptr<IGraph> {
+            return std::make_unique<Graph>(graph);
+          }};
+}
+
+std::vector<Representation> Representations() {
+  return {MutableRepresentation<ListGraph>("ListGraph", false),
+          MutableRepresentation<SetGraph>("SetGraph", false),
+          MutableRepresentation<MatrixGraph>("MatrixGraph", true),
+          MutableRepresentation<ArcGraph>("ArcGraph", false),
+          {"CSRGraph", false,
+           [](const GeneratedGraph& generated) -> std::unique_ptr<IGraph> {
+             GraphBuilder builder(generated.num_vertices);
+             builder.AddEdges(generated.edges);
+             return std::make_unique<CSRGraph>(builder.BuildCSRGraph());
+           },
+           [](const IGraph* graph) -> std::unique_ptr<IGraph> {
+             return std::make_unique<CSRGraph>(graph);
+           }}};
+}
+
+class Reporter {
+ public:
+  explicit Reporter(const GeneratedGraph& graph) {
+    std::ostringstream prefix;
+    prefix << graph.name << ',' << graph.num_vertices << ','
+           << graph.edges.size() << ',';
+    prefix_ = prefix.str();
+  }
+
+  void operator()(const std::string& representation, const std::string& metric,
+                  double value) const {
+    std::cout << prefix_ << representation << ',' << metric << ',' << value
+              << '\n';
+  }
+
+ private:
+  std::string prefix_;
+};
+
+// Returns the number of edges scanned
+size_t BreadthFirstSearch(const IGraph& graph) {
+  auto visited = std::vector<bool>(graph.VerticesCount(), false);
+  size_t scanned = 0;
+  std::queue<Vertex> queue;
+  for (Vertex start = 0; start < graph.VerticesCount(); ++start) {
+    if (visited[start]) {
+      continue;
+    }
+    visited[start] = true;
+    queue.push(start);
+    while (!queue.empty()) {
+      Vertex current = queue.front();
+      queue.pop();
+      for (auto next : graph.NextVertices(current)) {
+        ++scanned;
+        if (!visited[next]) {
+          visited[next] = true;
+          queue.push(next);
+        }
+      }
+    }
+  }
+  return scanned;
+}
+
+size_t DepthFirstSearch(const IGraph& graph) {
+  auto visited = std::vector<bool>(graph.VerticesCount(), false);
+  size_t scanned = 0;
+  std::stack<Vertex> stack;
+  for (Vertex start = 0; start < graph.VerticesCount(); ++start) {
+    if (visited[start]) {
+      continue;
+    }
+    stack.push(start);
+    while (!stack.empty()) {
+      Vertex current = stack.top();
+      stack.pop();
+      if (visited[current]) {
+        continue;
+      }
+      visited[current] = true;
+      for (auto next : graph.NextVertices(current)) {
+        ++scanned;
+        if (!visited[next]) {
+          stack.push(next);
+        }
+      }
+    }
+  }
+  return scanned;
+}
+
+void MeasureQueries(const IGraph& graph, size_t num_queries,
+                    const std::string& name, const Reporter& report) {
+  std::mt19937_64 generator(7);
+  std::uniform_int_distribution<Vertex> vertex(0, graph.VerticesCount() - 1);
+  auto latencies = std::vector<double>();
+  latencies.reserve(num_queries);
+  size_t checksum = 0;
+  for (size_t i = 0; i < num_queries; ++i) {
+    Vertex query = vertex(generator);
+    auto start = Clock::now();
+    for (auto next : graph.NextVertices(query)) {
+      checksum += next;
+    }
+    latencies.push_back(
+        std::chrono::duration<double, std::nano>(Clock::now() - start)
+            .count());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  for (auto [metric, quantile] :
+       {std::make_pair("query_p50_ns", 0.5),
+        std::make_pair("query_p90_ns", 0.9),
+        std::make_pair("query_p99_ns", 0.99)}) {
+    report(name, metric, latencies[quantile * (latencies.size() - 1)]);
+  }
+  report(name, "query_max_ns", latencies.back());
+  // Keeps the loop above from being optimized out
+  report(name, "query_checksum", checksum % 1000);
+}
+
+void RunSuite(const GeneratedGraph& generated, size_t num_queries,
+              size_t max_dense) {
+  Reporter report(generated);
+  auto representations = Representations();
+  auto graphs = std::vector<std::unique_ptr<IGraph>>(representations.size());
+
+  for (size_t i = 0; i < representations.size(); ++i) {
+    const auto& representation = representations[i];
+    if (representation.dense && generated.num_vertices > max_dense) {
+      continue;
+    }
+    size_t bytes_before = live_bytes;
+    auto start = Clock::now();
+    graphs[i] = representation.build(generated);
+    report(representation.name, "build_s", SecondsSince(start));
+
+    start = Clock::now();
+    size_t scanned = BreadthFirstSearch(*graphs[i]);
+    report(representation.name, "bfs_edges_per_s",
+           scanned / SecondsSince(start));
+    // Taken after the first traversal so lazily built indices count too
+    report(representation.name, "memory_bytes",
+           static_cast<double>(live_bytes - bytes_before));
+    start = Clock::now();
+    scanned = DepthFirstSearch(*graphs[i]);
+    report(representation.name, "dfs_edges_per_s",
+           scanned / SecondsSince(start));
+    MeasureQueries(*graphs[i], num_queries, representation.name, report);
+  }
+
+  for (size_t from = 0; from < representations.size(); ++from) {
+    for (size_t to = 0; to < representations.size(); ++to) {
+      if (from == to || !graphs[from] ||
+          (representations[to].dense && generated.num_vertices > max_dense)) {
+        continue;
+      }
+      auto start = Clock::now();
+      auto converted = representations[to].convert(graphs[from].get());
+      report(representations[from].name + "->" + representations[to].name,
+             "convert_s", SecondsSince(start));
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  size_t num_vertices = 100000;
+  size_t degree = 8;
+  size_t num_queries = 100000;
+  size_t max_dense = 10000;
+  std::string generators = "er,powerlaw,grid,road";
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string option = argv[i];
+    std::string value = argv[i + 1];
+    if (option == "--vertices") {
+      num_vertices = std::stoull(value);
+    } else if (option == "--degree") {
+      degree = std::stoull(value);
+    } else if (option == "--queries") {
+      num_queries = std::stoull(value);
+    } else if (option == "--max-dense") {
+      max_dense = std::stoull(value);
+    } else if (option == "--generators") {
+      generators = value;
+    } else {
+      std::cerr << "Unknown option " << option << std::endl;
+      return 1;
+    }
+  }
+
+  std::mt19937_64 generator(42);
+  std::cout.precision(12);
+  std::cout << "generator,vertices,edges,representation,metric,value\n";
+  std::istringstream names(generators);
+  std::string name;
+  while (std::getline(names, name, ',')) {
+    GeneratedGraph graph;
+    if (name == "er") {
+      graph = ErdosRenyi(num_vertices, degree, generator);
+    } else if (name == "powerlaw") {
+      graph = PowerLaw(num_vertices, degree, generator);
+    } else if (name == "grid") {
+      graph = Grid(num_vertices);
+    } else if (name == "road") {
+      graph = RoadLike(num_vertices, generator);
+    } else {
+      std::cerr << "Unknown generator " << name << std::endl;
+      return 1;
+    }
+    RunSuite(graph, num_queries, max_dense);
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Converts the text edge lists read by the programs in graph/ into the binary
+// graph file format (see GraphFile.h).
+//
+// Usage: convert [--weighted] [--undirected] [--one-based] output.bin < input
+// Input: "num_vertices num_edges" followed by num_edges lines
+// "from to" or "from to weight".
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../GraphBuilder.h"
+#include "../GraphFile.h"
+
+int main(int argc, char** argv) {
+  bool weighted = false;
+  bool undirected = false;
+  bool one_based = false;
+  std::string output_path;
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    if (argument == "--weighted") {
+      weighted = true;
+    } else if (argument == "--undirected") {
+      undirected = true;
+    } else if (argument == "--one-based") {
+      one_based = true;
+    } else {
+      output_path = argument;
+    }
+  }
+  if (output_path.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--weighted] [--undirected] [--one-based] output.bin"
+              << std::endl;
+    return 1;
+  }
+
+  std::ios::sync_with_stdio(false);
+  size_t num_vertices = 0;
+  size_t num_edges = 0;
+  if (!(std::cin >> num_vertices >> num_edges)) {
+    std::cerr << "Cannot read the graph size" << std::endl;
+    return 1;
+  }
+
+  std::vector<Edge> edges;
+  std::vector<int64_t> input_weights;
+  edges.reserve(undirected ? 2 * num_edges : num_edges);
+  for (size_t i = 0; i < num_edges; ++i) {
+    Vertex from = 0;
+    Vertex to = 0;
+    int64_t weight = 0;
+    std::cin >> from >> to;
+    if (weighted) {
+      std::cin >> weight;
+    }
+    if (!std::cin) {
+      std::cerr << "Cannot read edge " << i << std::endl;
+      return 1;
+    }
+    if (one_based) {
+      --from;
+      --to;
+    }
+    if (from >= num_vertices || to >= num_vertices) {
+      std::cerr << "Edge " << i << " is out of range" << std::endl;
+      return 1;
+    }
+    edges.emplace_back(from, to);
+    input_weights.push_back(weight);
+    if (undirected) {
+      edges.emplace_back(to, from);
+      input_weights.push_back(weight);
+    }
+  }
+
+  std::vector<Edge> edges_copy;
+  if (weighted) {
+    edges_copy = edges;
+  }
+  GraphBuilder builder(num_vertices);
+  builder.AddEdges(std::move(edges));
+  CSRGraph graph = builder.BuildCSRGraph();
+
+  // The builder scatters stably, so replaying the input order against the
+  // offsets puts every weight next to its target.
+  std::vector<int64_t> weights;
+  if (weighted) {
+    weights.resize(graph.EdgesCount());
+    auto position = std::vector<size_t>(graph.NextOffsets().begin(),
+                                        graph.NextOffsets().end() - 1);
+    for (size_t i = 0; i < edges_copy.size(); ++i) {
+      weights[position[edges_copy[i].first]++] = input_weights[i];
+    }
+  }
+
+  if (!WriteGraphFile(output_path, graph, weights)) {
+    std::cerr << "Cannot write " << output_path << std::endl;
+    return 1;
+  }
+  return 0;
+}
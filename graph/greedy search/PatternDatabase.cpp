@@ -0,0 +1,305 @@
+#include "PatternDatabase.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+const int kSide = 4;
+const int kCells = kSide * kSide;
+
+// "PDB4" little-endian
+const uint32_t kPatternMagic = 0x34424450;
+const uint32_t kPatternVersion = 1;
+
+struct PatternHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_tiles;
+  uint8_t tiles[PatternDatabase::kMaxTiles + 1];
+  uint64_t num_entries;
+};
+
+const uint8_t kUnvisited = 0xFF;
+const uint8_t kMaxNibble = 0xF;
+
+// Sequences of count distinct cells
+uint64_t PlacementsCount(size_t count) {
+  uint64_t placements = 1;
+  for (size_t i = 0; i < count; ++i) {
+    placements *= kCells - i;
+  }
+  return placements;
+}
+
+// Index of cells[0..count) among the sequences of count distinct cells:
+// mixed radix 16, 15, ... over each cell's rank among the cells not used
+// before it
+uint64_t RankCells(const uint8_t* cells, size_t count) {
+  uint64_t index = 0;
+  uint32_t used = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t below = used & ((1u << cells[i]) - 1);
+    index = index * (kCells - i) + cells[i] - __builtin_popcount(below);
+    used |= 1u << cells[i];
+  }
+  return index;
+}
+
+void UnrankCells(uint64_t index, size_t count, uint8_t* cells) {
+  uint8_t digits[PatternDatabase::kMaxTiles + 1];
+  for (size_t i = count; i-- > 0;) {
+    digits[i] = index % (kCells - i);
+    index /= kCells - i;
+  }
+  uint32_t used = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint8_t cell = 0;
+    for (uint8_t skip = digits[i];; ++cell) {
+      if ((used >> cell & 1) == 0 && skip-- == 0) {
+        break;
+      }
+    }
+    cells[i] = cell;
+    used |= 1u << cell;
+  }
+}
+
+int Manhattan(uint8_t cell, uint8_t tile) {
+  int home = tile - 1;
+  return std::abs(cell % kSide - home % kSide) +
+         std::abs(cell / kSide - home / kSide);
+}
+
+// Cell next to cell in direction 0..3, or -1 at the border
+int NeighborCell(int cell, int direction) {
+  switch (direction) {
+    case 0:
+      return cell % kSide > 0 ? cell - 1 : -1;
+    case 1:
+      return cell % kSide < kSide - 1 ? cell + 1 : -1;
+    case 2:
+      return cell >= kSide ? cell - kSide : -1;
+    default:
+      return cell < kCells - kSide ? cell + kSide : -1;
+  }
+}
+
+void Gather(std::vector<std::vector<uint32_t>>& parts,
+            std::vector<uint32_t>& states) {
+  states.clear();
+  for (auto& part : parts) {
+    states.insert(states.end(), part.begin(), part.end());
+    part.clear();
+  }
+}
+
+}  // namespace
+
+PatternDatabase::~PatternDatabase() { Close(); }
+
+void PatternDatabase::Build(const std::vector<uint8_t>& tiles,
+                            size_t num_threads) {
+  assert(!tiles.empty() && tiles.size() <= kMaxTiles);
+  Close();
+  tiles_ = tiles;
+  size_t count = tiles.size();
+  num_threads = std::max<size_t>(1, num_threads);
+
+  // A state is the blank's cell followed by the tiles' cells
+  size_t num_states = PlacementsCount(count + 1);
+  auto distance = std::vector<std::atomic<uint8_t>>(num_states);
+  ParallelFor(0, num_states, num_threads,
+              [&](size_t begin, size_t end, size_t /*thread*/) {
+                for (size_t state = begin; state < end; ++state) {
+                  distance[state].store(kUnvisited, std::memory_order_relaxed);
+                }
+              });
+
+  uint8_t solved[kMaxTiles + 1];
+  solved[0] = kCells - 1;
+  for (size_t i = 0; i < count; ++i) {
+    assert(1 <= tiles[i] && tiles[i] < kCells);
+    solved[i + 1] = tiles[i] - 1;
+  }
+  auto start = static_cast<uint32_t>(RankCells(solved, count + 1));
+  distance[start].store(0, std::memory_order_relaxed);
+
+  std::vector<uint32_t> frontier(1, start);
+  std::vector<uint32_t> next_level;
+  auto level_parts = std::vector<std::vector<uint32_t>>(num_threads);
+  auto next_parts = std::vector<std::vector<uint32_t>>(num_threads);
+  for (uint8_t level = 0; !frontier.empty(); ++level) {
+    assert(level + 1 < kUnvisited);
+    // Moves of the other tiles are free, so a level keeps growing until
+    // they reach nothing new. A state first met one level up is moved down
+    // when a free move reaches it; it is then skipped on the next level.
+    while (!frontier.empty()) {
+      ParallelFor(
+          0, frontier.size(), num_threads,
+          [&](size_t begin, size_t end, size_t thread) {
+            uint8_t cells[kMaxTiles + 1];
+            uint8_t next[kMaxTiles + 1];
+            for (size_t i = begin; i < end; ++i) {
+              UnrankCells(frontier[i], count + 1, cells);
+              uint8_t blank = cells[0];
+              for (int direction = 0; direction < 4; ++direction) {
+                int cell = NeighborCell(blank, direction);
+                if (cell < 0) {
+                  continue;
+                }
+                bool counted = false;
+                next[0] = cell;
+                for (size_t j = 1; j <= count; ++j) {
+                  next[j] = cells[j];
+                  if (cells[j] == cell) {
+                    next[j] = blank;
+                    counted = true;
+                  }
+                }
+                auto state = static_cast<uint32_t>(RankCells(next, count + 1));
+                uint8_t target = counted ? level + 1 : level;
+                uint8_t seen = distance[state].load(std::memory_order_relaxed);
+                while (seen > target) {
+                  if (distance[state].compare_exchange_weak(
+                          seen, target, std::memory_order_relaxed)) {
+                    (counted ? next_parts : level_parts)[thread].push_back(
+                        state);
+                    break;
+                  }
+                }
+              }
+            }
+          });
+      Gather(level_parts, frontier);
+    }
+    Gather(next_parts, next_level);
+    for (auto state : next_level) {
+      if (distance[state].load(std::memory_order_relaxed) == level + 1) {
+        frontier.push_back(state);
+      }
+    }
+  }
+
+  // Drop the blank: an entry is the best over its free cells. Threads get
+  // whole bytes, so no nibble is shared.
+  num_entries_ = PlacementsCount(count);
+  built_.assign((num_entries_ + 1) / 2, 0);
+  ParallelFor(
+      0, built_.size(), num_threads,
+      [&](size_t begin, size_t end, size_t /*thread*/) {
+        uint8_t cells[kMaxTiles + 1];
+        for (size_t entry = 2 * begin; entry < std::min(2 * end, num_entries_);
+             ++entry) {
+          UnrankCells(entry, count, cells + 1);
+          uint32_t used = 0;
+          int manhattan = 0;
+          for (size_t j = 0; j < count; ++j) {
+            used |= 1u << cells[j + 1];
+            manhattan += Manhattan(cells[j + 1], tiles_[j]);
+          }
+          uint8_t best = kUnvisited;
+          for (int blank = 0; blank < kCells; ++blank) {
+            if ((used >> blank & 1) == 0) {
+              cells[0] = blank;
+              best = std::min(best, distance[RankCells(cells, count + 1)].load(
+                                        std::memory_order_relaxed));
+            }
+          }
+          assert(best != kUnvisited && best >= manhattan &&
+                 (best - manhattan) % 2 == 0);
+          // Capping only lowers the bound
+          auto nibble = static_cast<uint8_t>(
+              std::min<int>((best - manhattan) / 2, kMaxNibble));
+          built_[entry / 2] |= nibble << (4 * (entry % 2));
+        }
+      });
+  nibbles_ = built_.data();
+}
+
+bool PatternDatabase::Save(const std::string& path) const {
+  assert(nibbles_ != nullptr);
+  PatternHeader header = {};
+  header.magic = kPatternMagic;
+  header.version = kPatternVersion;
+  header.num_tiles = tiles_.size();
+  std::copy(tiles_.begin(), tiles_.end(), header.tiles);
+  header.num_entries = num_entries_;
+  std::ofstream output(path, std::ios::binary);
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(nibbles_),
+               (num_entries_ + 1) / 2);
+  return static_cast<bool>(output);
+}
+
+bool PatternDatabase::Open(const std::string& path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(PatternHeader)) {
+    close(fd);
+    return false;
+  }
+  size_ = file_stat.st_size;
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    return false;
+  }
+  auto header = static_cast<const PatternHeader*>(data_);
+  size_t count = header->num_tiles;
+  if (header->magic != kPatternMagic || header->version != kPatternVersion ||
+      count == 0 || count > kMaxTiles ||
+      header->num_entries != PlacementsCount(count) ||
+      size_ != sizeof(PatternHeader) + (header->num_entries + 1) / 2) {
+    Close();
+    return false;
+  }
+  uint32_t seen = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint8_t tile = header->tiles[i];
+    if (tile == 0 || tile >= kCells || (seen >> tile & 1) != 0) {
+      Close();
+      return false;
+    }
+    seen |= 1u << tile;
+  }
+  tiles_.assign(header->tiles, header->tiles + count);
+  num_entries_ = header->num_entries;
+  nibbles_ = reinterpret_cast<const uint8_t*>(header + 1);
+  return true;
+}
+
+void PatternDatabase::Close() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  built_.clear();
+  built_.shrink_to_fit();
+  tiles_.clear();
+  num_entries_ = 0;
+  nibbles_ = nullptr;
+}
+
+int PatternDatabase::Lookup(const uint8_t* positions) const {
+  uint8_t cells[kMaxTiles];
+  int manhattan = 0;
+  for (size_t j = 0; j < tiles_.size(); ++j) {
+    cells[j] = positions[tiles_[j]];
+    manhattan += Manhattan(cells[j], tiles_[j]);
+  }
+  uint64_t entry = RankCells(cells, tiles_.size());
+  return manhattan + 2 * ((nibbles_[entry / 2] >> (4 * (entry % 2))) & 0xF);
+}
@@ -0,0 +1,64 @@
+#ifndef GREEDY_SEARCH_PATTERN_DATABASE_H
+#define GREEDY_SEARCH_PATTERN_DATABASE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../graphs/Parallel.h"
+
+// Additive pattern database for the 15-puzzle. Cells are numbered row by
+// row from 0, tile t belongs in cell t - 1 and the blank in cell 15.
+//
+// For a group of tiles it holds, for every placement of those tiles, the
+// least number of moves *of the group's tiles* that bring them home,
+// whatever the other tiles do. Since other moves are free, the values of
+// disjoint groups add up to a lower bound for the whole board.
+//
+// A value is never below the group's Manhattan distance and has the same
+// parity (every counted move shifts one group tile by one cell), so an entry
+// is the nibble (value - manhattan) / 2, two entries to a byte.
+class PatternDatabase {
+ public:
+  static constexpr size_t kMaxTiles = 7;
+
+  PatternDatabase() = default;
+
+  PatternDatabase(const PatternDatabase&) = delete;
+
+  PatternDatabase& operator=(const PatternDatabase&) = delete;
+
+  ~PatternDatabase();
+
+  // Retrograde breadth-first search from the solved placement over the
+  // placements of the tiles and the blank. Levels are processed one at a
+  // time, each frontier split between the threads.
+  void Build(const std::vector<uint8_t>& tiles,
+             size_t num_threads = DefaultThreadsCount());
+
+  // A small header (tiles and size) followed by the nibbles; Open maps it
+  bool Save(const std::string& path) const;
+
+  bool Open(const std::string& path);
+
+  void Close();
+
+  const std::vector<uint8_t>& Tiles() const { return tiles_; }
+
+  size_t EntriesCount() const { return num_entries_; }
+
+  // Lower bound on the moves of the group's tiles; positions[tile] is the
+  // cell of tile, for tiles 1..15
+  int Lookup(const uint8_t* positions) const;
+
+ private:
+  std::vector<uint8_t> tiles_;
+  size_t num_entries_ = 0;
+  const uint8_t* nibbles_ = nullptr;
+  // The nibbles of a built database
+  std::vector<uint8_t> built_;
+  // The mapping of an opened one
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+#endif  // GREEDY_SEARCH_PATTERN_DATABASE_H
@@ -0,0 +1,95 @@
+// Builds additive pattern databases for the 15-puzzle solver (see
+// PatternDatabase.h), one file per group of tiles.
+//
+// Usage: build-pdb output_prefix [tiles ...]
+// Each tiles argument is a comma-separated group, e.g. "1,5,6,9,10,13"; the
+// default is the 6-6-3 partition. Writes output_prefix-1.pdb, -2.pdb, ...,
+// to be passed to the solver.
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../PatternDatabase.h"
+
+// Tile numbers are 1..15; false on anything else, including "x" or "5x"
+bool ParseTile(const std::string& text, uint8_t& tile) {
+  size_t length = 0;
+  int value = 0;
+  try {
+    value = std::stoi(text, &length);
+  } catch (const std::logic_error&) {
+    return false;
+  }
+  if (length != text.size() || value < 1 || value > 15) {
+    return false;
+  }
+  tile = static_cast<uint8_t>(value);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  auto usage = [&]() {
+    std::cerr << "Usage: " << argv[0] << " output_prefix [tiles ...]"
+              << std::endl;
+  };
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+  std::string prefix = argv[1];
+  std::vector<std::vector<uint8_t>> groups;
+  for (int i = 2; i < argc; ++i) {
+    std::vector<uint8_t> group;
+    std::istringstream stream(argv[i]);
+    std::string text;
+    while (std::getline(stream, text, ',')) {
+      uint8_t tile = 0;
+      if (!ParseTile(text, tile)) {
+        std::cerr << "Bad tile \"" << text << "\" in " << argv[i]
+                  << std::endl;
+        usage();
+        return 1;
+      }
+      group.push_back(tile);
+    }
+    groups.push_back(group);
+  }
+  if (groups.empty()) {
+    groups = {{1, 5, 6, 9, 10, 13}, {7, 8, 11, 12, 14, 15}, {2, 3, 4}};
+  }
+
+  uint32_t covered = 0;
+  for (const auto& group : groups) {
+    if (group.empty() || group.size() > PatternDatabase::kMaxTiles) {
+      std::cerr << "A group has 1 to " << PatternDatabase::kMaxTiles
+                << " tiles" << std::endl;
+      return 1;
+    }
+    for (auto tile : group) {
+      if (tile == 0 || tile > 15 || (covered >> tile & 1) != 0) {
+        std::cerr << "Tiles are 1..15, each in one group" << std::endl;
+        return 1;
+      }
+      covered |= 1u << tile;
+    }
+  }
+
+  for (size_t i = 0; i < groups.size(); ++i) {
+    auto start = std::chrono::steady_clock::now();
+    PatternDatabase database;
+    database.Build(groups[i]);
+    std::string path = prefix + "-" + std::to_string(i + 1) + ".pdb";
+    if (!database.Save(path)) {
+      std::cerr << "Cannot write " << path << std::endl;
+      return 1;
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    std::cout << path << ": " << database.EntriesCount() << " entries, "
+              << seconds << " s" << std::endl;
+  }
+}
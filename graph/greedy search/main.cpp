@@ -1,9 +1,12 @@
 #include <cassert>
 #include <iostream>
-#include <queue>
-#include <set>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "../graphs/AStar.h"
+#include "PatternDatabase.h"
+
 const int number4 = 4;
 const int number5 = 5;
 const int number6 = 6;
@@ -65,7 +68,6 @@ class BoardArrangement {
         null_pos_ = i;
       }
     }
-    actions_ = 0;
   }
 
   BoardArrangement() {
@@ -74,15 +76,13 @@ class BoardArrangement {
     }
     bitset_ = final_arrangement;
     null_pos_ = number15;
-    actions_ = 0;
   }
 
   BoardArrangement(const BoardArrangement& other) = default;
 
   BoardArrangement(const BoardArrangement& last, Action action)
       : bitset_(last.bitset_),
-        null_pos_(last.null_pos_),
-        actions_(last.actions_ + 1) {
+        null_pos_(last.null_pos_) {
     int d_coord = 0;
     switch (action) {
       case Action::LEFT:
@@ -126,12 +126,8 @@ class BoardArrangement {
     return (bitset_ >> (number4 * (number15 - index))) & first_digit_mask;
   }
 
-  int Heuristic() const { return HScore() + GScore(); }
-
   int HScore() const { return static_cast<int>(FindManhattanDistance()); }
 
-  int GScore() const { return actions_; }
-
   bool IsActionPossible(Action action) const {
     bool answer = false;
     switch (action) {
@@ -204,97 +200,132 @@ class BoardArrangement {
     return distance;
   }
 
-  bool operator==(const BoardArrangement& rhs) {
+  bool operator==(const BoardArrangement& rhs) const {
     return rhs.bitset_ == bitset_;
   }
 
   bool IsFinal() const { return bitset_ == final_arrangement; }
 
  private:
-  int actions_;
   uint64_t bitset_;
   uint8_t null_pos_;
 };
 
-bool operator<(const BoardArrangement& lhs, const BoardArrangement& rhs) {
-  return (lhs.HScore() == rhs.HScore() ? lhs.GetBitset() > rhs.GetBitset()
-                                       : lhs.HScore() > rhs.HScore());
-}
+struct AdjacentArrangements {
+  template <typename Emit>
+  void operator()(const BoardArrangement& current, Emit emit) const {
+    for (auto action :
+         {Action::UP, Action::DOWN, Action::LEFT, Action::RIGHT}) {
+      if (current.IsActionPossible(action)) {
+        emit(action, BoardArrangement(current, action), 1);
+      }
+    }
+  }
+};
 
-struct Path {
-  Path(const BoardArrangement& initial) : last(initial) {}
+using PatternDatabases = std::vector<std::unique_ptr<PatternDatabase>>;
 
-  Path(const Path& path, Action action)
-      : actions(path.actions), last(BoardArrangement(path.last, action)) {
-    actions.push_back(action);
+// Sum of disjoint pattern databases plus the Manhattan distance of the tiles
+// none of them covers; HScore when there are no databases
+class PatternHeuristic {
+ public:
+  explicit PatternHeuristic(const PatternDatabases& databases)
+      : databases_(&databases) {
+    uint32_t covered = 0;
+    for (const auto& database : databases) {
+      for (auto tile : database->Tiles()) {
+        covered |= 1u << tile;
+      }
+    }
+    for (uint8_t tile = 1; tile < number16; ++tile) {
+      if ((covered >> tile & 1) == 0) {
+        uncovered_.push_back(tile);
+      }
+    }
+  }
+
+  int operator()(const BoardArrangement& board) const {
+    if (databases_->empty()) {
+      return board.HScore();
+    }
+    uint8_t positions[number16];
+    for (uint8_t i = 0; i < number16; ++i) {
+      positions[board.GetAtPos(i)] = i;
+    }
+    int estimate = 0;
+    for (const auto& database : *databases_) {
+      estimate += database->Lookup(positions);
+    }
+    for (auto tile : uncovered_) {
+      estimate += Point2D::Distance(
+          Point2D(positions[tile] % number4, positions[tile] / number4),
+          Point2D((tile - 1) % number4, (tile - 1) / number4));
+    }
+    return estimate;
   }
 
-  std::vector<Action> actions;
-  BoardArrangement last;
+ private:
+  const PatternDatabases* databases_;
+  std::vector<uint8_t> uncovered_;
 };
 
-bool operator<(const Path& lhs, const Path& rhs) { return lhs.last < rhs.last; }
+struct BoardHash {
+  size_t operator()(const BoardArrangement& board) const {
+    return board.GetBitset();
+  }
+};
 
 class TagGameSolver {
  public:
-  TagGameSolver() = default;
+  explicit TagGameSolver(const PatternDatabases& databases)
+      : engine_(AdjacentArrangements(), PatternHeuristic(databases)) {}
 
   int FindMinPath(const BoardArrangement& initial, std::string& output_path) {
-    closed_ = std::set<BoardArrangement>();
-
-    open_ = std::priority_queue<Path>();
-    open_.emplace(initial);
-    while (!open_.empty()) {
-      auto path = open_.top();
-      auto current = path.last;
-      open_.pop();
-
-      if (closed_.find(current) != closed_.end()) {
-        continue;
-      }
-
-      if (current.IsFinal()) {
-        GetAnswer(path, output_path);
-        // Output min_path size
-        return current.GScore();
-      }
-
-      AddAdjacentArrangements(path);
-      closed_.insert(current);
+    AStarOptions options;
+    // Greedy best-first: expands by the distance estimate alone
+    options.greedy = true;
+    auto result = engine_.Search(initial, IsFinal, options);
+    if (!result.found) {
+      std::cout << "FAIL" << std::endl;
+      return -1;
     }
-    std::cout << "FAIL" << std::endl;
-    return -1;
-  }
-
-  void GetAnswer(Path& path, std::string& output_path) {
     output_path = "";
-    for (auto action : path.actions) {
+    for (auto action : result.actions) {
       output_path.push_back(InvertedActionToChar(action));
     }
+    return result.cost;
   }
 
-  void AddAdjacentArrangements(Path& path) {
-    auto current = path.last;
-    if (current.IsActionPossible(Action::UP)) {
-      open_.emplace(path, Action::UP);
-    }
-    if (current.IsActionPossible(Action::DOWN)) {
-      open_.emplace(path, Action::DOWN);
-    }
-    if (current.IsActionPossible(Action::LEFT)) {
-      open_.emplace(path, Action::LEFT);
-    }
-    if (current.IsActionPossible(Action::RIGHT)) {
-      open_.emplace(path, Action::RIGHT);
-    }
+ private:
+  static bool IsFinal(const BoardArrangement& board) {
+    return board.IsFinal();
   }
 
- private:
-  std::set<BoardArrangement> closed_;
-  std::priority_queue<Path> open_;
+  AStarEngine<BoardArrangement, Action, AdjacentArrangements,
+              PatternHeuristic, BoardHash>
+      engine_;
 };
 
-int main() {
+// Arguments are pattern database files made by build-pdb, for disjoint
+// groups of tiles; without them the search is guided by Manhattan distance
+int main(int argc, char** argv) {
+  PatternDatabases databases;
+  uint32_t covered = 0;
+  for (int i = 1; i < argc; ++i) {
+    databases.push_back(std::make_unique<PatternDatabase>());
+    if (!databases.back()->Open(argv[i])) {
+      std::cerr << "Cannot open pattern database " << argv[i] << std::endl;
+      return 1;
+    }
+    for (auto tile : databases.back()->Tiles()) {
+      if ((covered >> tile & 1) != 0) {
+        std::cerr << "Pattern databases share tile " << int(tile) << std::endl;
+        return 1;
+      }
+      covered |= 1u << tile;
+    }
+  }
+
   std::vector<uint8_t> first_configuration;
   for (int i = 0; i < number16; ++i) {
     int digit = 0;
@@ -306,7 +337,7 @@ int main() {
   if (arrangement.FindParityInvariant() == BoardArrangement::Parity::ODD) {
     std::cout << -1;
   } else {
-    TagGameSolver solver;
+    TagGameSolver solver(databases);
     std::string actions;
     std::cout << solver.FindMinPath(arrangement, actions) << std::endl;
     std::cout << actions << std::endl;
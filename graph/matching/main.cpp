@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include "../graphs/BipartiteMatching.h"
+#include "../graphs/GraphBuilder.h"
+
+// Reads "V E" and E undirected edges "from to" with 0-based vertices, as
+// the scc tool does. Prints NO if the graph is not bipartite, otherwise
+// the size of a maximum matching and its edges, one "from to" per line.
+// --greedy starts Hopcroft-Karp from a parallel greedy matching.
+int main(int argc, char** argv) {
+  MatchingOptions options;
+  if (argc > 1 && std::string(argv[1]) == "--greedy") {
+    options.greedy_start = true;
+  }
+  std::ios::sync_with_stdio(false);
+  size_t num_vertices = 0;
+  size_t num_edges = 0;
+  std::cin >> num_vertices >> num_edges;
+  GraphBuilder builder(num_vertices);
+  for (size_t i = 0; i < num_edges; ++i) {
+    Vertex from = 0;
+    Vertex to = 0;
+    std::cin >> from >> to;
+    builder.AddEdge(from, to);
+    builder.AddEdge(to, from);
+  }
+  auto graph = builder.BuildCSRGraph();
+
+  auto bipartition = FindBipartition(graph);
+  if (!bipartition.bipartite) {
+    std::cout << "NO" << std::endl;
+    return 0;
+  }
+  auto matching = FindMaximumMatching(graph, bipartition.side, options);
+  std::cout << matching.size << '\n';
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (bipartition.side[vertex] == 0 &&
+        matching.mate[vertex] != MatchingResult::kNoMate) {
+      std::cout << vertex << ' ' << matching.mate[vertex] << '\n';
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+#ifndef MST_MINIMUM_SPANNING_TREE_H
+#define MST_MINIMUM_SPANNING_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "../graphs/DisjointSets.h"
+#include "../graphs/IGraph.h"
+#include "../graphs/Parallel.h"
+
+enum class MstAlgorithm { Kruskal, Boruvka };
+
+template <typename Weight>
+struct UndirectedEdge {
+  Vertex from;
+  Vertex to;
+  Weight weight;
+};
+
+template <typename Weight>
+struct SpanningForest {
+  Weight weight = 0;
+  // Indices of the chosen edges, in no particular order
+  std::vector<size_t> edges;
+  size_t components = 0;
+};
+
+// Minimum spanning forest of an undirected graph given as an edge list
+// (each edge once). Edges are ordered by weight and then by index, so the
+// forest is unique and both algorithms return the same one.
+//
+// Kruskal sorts the edge indices with ParallelSort and scans them through
+// a union-find. Boruvka runs in rounds: every thread takes a block of the
+// remaining edges and lowers the cheapest-edge slots of both endpoints'
+// components with compare-exchange; the chosen edges are united, vertices
+// get their new component labels and edges inside one component are
+// dropped, again in parallel. Each round at least halves the number of
+// components.
+template <typename Weight>
+class MinimumSpanningTree {
+ public:
+  MinimumSpanningTree(size_t num_vertices,
+                      const std::vector<UndirectedEdge<Weight>>& edges)
+      : num_vertices_(num_vertices), edges_(edges) {}
+
+  SpanningForest<Weight> Run(
+      MstAlgorithm algorithm = MstAlgorithm::Kruskal,
+      size_t num_threads = DefaultThreadsCount()) const {
+    num_threads = std::max<size_t>(1, num_threads);
+    return algorithm == MstAlgorithm::Kruskal ? Kruskal(num_threads)
+                                              : Boruvka(num_threads);
+  }
+
+ private:
+  static constexpr size_t kNoEdge = std::numeric_limits<size_t>::max();
+
+  bool Lighter(size_t first, size_t second) const {
+    if (second == kNoEdge) {
+      return true;
+    }
+    const auto& left = edges_[first];
+    const auto& right = edges_[second];
+    return left.weight < right.weight ||
+           (!(right.weight < left.weight) && first < second);
+  }
+
+  void Take(size_t edge, SpanningForest<Weight>& forest) const {
+    forest.weight += edges_[edge].weight;
+    forest.edges.push_back(edge);
+  }
+
+  SpanningForest<Weight> Kruskal(size_t num_threads) const {
+    std::vector<size_t> order(edges_.size());
+    std::iota(order.begin(), order.end(), 0);
+    ParallelSort(
+        order.begin(), order.end(),
+        [this](size_t first, size_t second) { return Lighter(first, second); },
+        num_threads);
+
+    SpanningForest<Weight> forest;
+    DisjointSets sets(num_vertices_);
+    for (auto edge : order) {
+      if (forest.edges.size() + 1 >= num_vertices_) {
+        break;
+      }
+      if (sets.Unite(edges_[edge].from, edges_[edge].to)) {
+        Take(edge, forest);
+      }
+    }
+    forest.components = num_vertices_ - forest.edges.size();
+    return forest;
+  }
+
+  SpanningForest<Weight> Boruvka(size_t num_threads) const {
+    SpanningForest<Weight> forest;
+    DisjointSets sets(num_vertices_);
+    std::vector<Vertex> component(num_vertices_);
+    std::iota(component.begin(), component.end(), 0);
+    std::vector<std::atomic<size_t>> cheapest(num_vertices_);
+    std::vector<size_t> alive;
+    for (size_t edge = 0; edge < edges_.size(); ++edge) {
+      if (edges_[edge].from != edges_[edge].to) {
+        alive.push_back(edge);
+      }
+    }
+    std::vector<std::vector<size_t>> parts(num_threads);
+
+    while (!alive.empty()) {
+      ParallelFor(0, num_vertices_, num_threads,
+                  [&](size_t begin, size_t end, size_t) {
+                    for (Vertex vertex = begin; vertex < end; ++vertex) {
+                      cheapest[vertex].store(kNoEdge,
+                                             std::memory_order_relaxed);
+                    }
+                  });
+      ParallelFor(0, alive.size(), num_threads,
+                  [&](size_t begin, size_t end, size_t) {
+                    for (size_t i = begin; i < end; ++i) {
+                      size_t edge = alive[i];
+                      Lower(cheapest[component[edges_[edge].from]], edge);
+                      Lower(cheapest[component[edges_[edge].to]], edge);
+                    }
+                  });
+
+      // Every slot belongs to a current component; a shared cheapest edge
+      // shows up twice and is united once
+      for (Vertex root = 0; root < num_vertices_; ++root) {
+        size_t edge = cheapest[root].load(std::memory_order_relaxed);
+        if (edge != kNoEdge && sets.Unite(edges_[edge].from,
+                                          edges_[edge].to)) {
+          Take(edge, forest);
+        }
+      }
+      ParallelFor(0, num_vertices_, num_threads,
+                  [&](size_t begin, size_t end, size_t) {
+                    for (Vertex vertex = begin; vertex < end; ++vertex) {
+                      component[vertex] = sets.Root(vertex);
+                    }
+                  });
+
+      for (auto& part : parts) {
+        part.clear();
+      }
+      ParallelFor(0, alive.size(), num_threads,
+                  [&](size_t begin, size_t end, size_t thread) {
+                    for (size_t i = begin; i < end; ++i) {
+                      const auto& edge = edges_[alive[i]];
+                      if (component[edge.from] != component[edge.to]) {
+                        parts[thread].push_back(alive[i]);
+                      }
+                    }
+                  });
+      size_t num_alive = 0;
+      for (const auto& part : parts) {
+        std::copy(part.begin(), part.end(), alive.begin() + num_alive);
+        num_alive += part.size();
+      }
+      alive.resize(num_alive);
+    }
+    forest.components = num_vertices_ - forest.edges.size();
+    return forest;
+  }
+
+  void Lower(std::atomic<size_t>& slot, size_t edge) const {
+    size_t current = slot.load(std::memory_order_relaxed);
+    while (Lighter(edge, current) &&
+           !slot.compare_exchange_weak(current, edge,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  size_t num_vertices_;
+  std::vector<UndirectedEdge<Weight>> edges_;
+};
+
+#endif  // MST_MINIMUM_SPANNING_TREE_H
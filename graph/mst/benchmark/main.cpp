@@ -0,0 +1,162 @@
+// Times Kruskal and Boruvka from MinimumSpanningTree.h against the two
+// Prim implementations of the tree: the one of mst-prim/main.cpp and
+// CoordinateGraph::FindMinimalSpanningTree of the tsp solver, both of
+// which keep their queue in a std::set.
+//
+// Usage: benchmark [sparse_vertices] [dense_points]
+// Workloads: a sparse graph (a random path through all sparse_vertices
+// vertices plus 4 random edges per vertex, weights in [1, 1000]) and a
+// dense one (the complete graph on dense_points random points in the unit
+// square with Euclidean weights).
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../../tsp/CoordinateGraph.cpp"
+#include "../MinimumSpanningTree.h"
+
+// The Prim of mst-prim/main.cpp, kept as the baseline
+class ListGraph {
+ public:
+  explicit ListGraph(const int num_vertices)
+      : next_vertices_(num_vertices, std::vector<std::pair<Vertex, size_t>>()) {
+  }
+
+  void AddEdge(Vertex from, Vertex to, size_t weight) {
+    assert(from < VerticesCount() && to < VerticesCount());
+    next_vertices_[from].emplace_back(to, weight);
+  }
+
+  size_t VerticesCount() const { return next_vertices_.size(); }
+
+  int MinSpanningTreeWeight() const {
+    const size_t inf = std::numeric_limits<size_t>::max();
+    int weight_sum = 0;
+    std::set<std::pair<size_t, Vertex>> edges;
+    std::vector<size_t> min_edge(VerticesCount(), inf);
+    std::vector<bool> is_added(VerticesCount(), false);
+    min_edge[0] = 0;
+    is_added[0] = true;
+    edges.emplace(0, 0);
+    for (size_t edges_added = 0; edges_added < VerticesCount();
+         ++edges_added) {
+      auto [key, current] = *edges.begin();
+      edges.erase(edges.begin());
+      weight_sum += key;
+      is_added[current] = true;
+      for (auto [next, weight] : next_vertices_[current]) {
+        if (weight < min_edge[next] && !is_added[next]) {
+          edges.erase(std::make_pair(min_edge[next], next));
+          min_edge[next] = weight;
+          edges.emplace(min_edge[next], next);
+        }
+      }
+    }
+    return weight_sum;
+  }
+
+ private:
+  std::vector<std::vector<std::pair<Vertex, size_t>>> next_vertices_;
+};
+
+template <typename Function>
+double Measure(const std::string& name, Function function) {
+  auto start = std::chrono::steady_clock::now();
+  auto weight = function();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  std::cout << "  " << name << ": " << seconds << " s, weight " << weight
+            << std::endl;
+  return seconds;
+}
+
+template <typename Weight, typename Baseline>
+bool Run(const std::string& name, size_t num_vertices,
+         const std::vector<UndirectedEdge<Weight>>& edges,
+         const std::string& baseline_name, Baseline baseline) {
+  std::cout << name << ": " << num_vertices << " vertices, " << edges.size()
+            << " edges" << std::endl;
+  MinimumSpanningTree<Weight> tree(num_vertices, edges);
+  Weight expected = 0;
+  Weight kruskal = 0;
+  Weight boruvka = 0;
+  double prim = Measure(baseline_name, [&] { return expected = baseline(); });
+  double seconds = Measure("Kruskal", [&] {
+    return kruskal = tree.Run(MstAlgorithm::Kruskal).weight;
+  });
+  std::cout << "    speedup x" << prim / seconds << std::endl;
+  seconds = Measure("Boruvka", [&] {
+    return boruvka = tree.Run(MstAlgorithm::Boruvka).weight;
+  });
+  std::cout << "    speedup x" << prim / seconds << std::endl;
+  // Floating-point sums depend on the order of the edges
+  auto agree = [expected](Weight weight) {
+    return std::abs(static_cast<double>(weight - expected)) <=
+           1e-9 * std::abs(static_cast<double>(expected));
+  };
+  return agree(kruskal) && agree(boruvka);
+}
+
+bool RunSparse(size_t num_vertices, std::mt19937_64& generator) {
+  const int kEdgesPerVertex = 4;
+  std::uniform_int_distribution<Vertex> vertex(0, num_vertices - 1);
+  std::uniform_int_distribution<size_t> weight(1, 1000);
+  std::vector<Vertex> order(num_vertices);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), generator);
+  std::vector<UndirectedEdge<size_t>> edges;
+  for (size_t i = 0; i + 1 < num_vertices; ++i) {
+    edges.push_back({order[i], order[i + 1], weight(generator)});
+  }
+  for (size_t i = 0; i < kEdgesPerVertex * num_vertices; ++i) {
+    edges.push_back({vertex(generator), vertex(generator), weight(generator)});
+  }
+  ListGraph graph(num_vertices);
+  for (const auto& edge : edges) {
+    graph.AddEdge(edge.from, edge.to, edge.weight);
+    graph.AddEdge(edge.to, edge.from, edge.weight);
+  }
+  return Run<size_t>("sparse", num_vertices, edges, "Prim (mst-prim)", [&] {
+    return static_cast<size_t>(graph.MinSpanningTreeWeight());
+  });
+}
+
+bool RunDense(size_t num_points, std::mt19937_64& generator) {
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  std::vector<double> x(num_points);
+  std::vector<double> y(num_points);
+  for (size_t i = 0; i < num_points; ++i) {
+    x[i] = coordinate(generator);
+    y[i] = coordinate(generator);
+  }
+  CoordinateGraph<double> graph(x, y);
+  std::vector<UndirectedEdge<double>> edges;
+  edges.reserve(num_points * (num_points - 1) / 2);
+  for (Vertex from = 0; from < num_points; ++from) {
+    for (Vertex to = from + 1; to < num_points; ++to) {
+      edges.push_back({from, to, graph.GetWeight(from, to)});
+    }
+  }
+  return Run<double>("dense", num_points, edges, "Prim (CoordinateGraph)",
+                     [&] { return graph.FindMinimalSpanningTree(); });
+}
+
+int main(int argc, char** argv) {
+  size_t sparse_vertices =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+  size_t dense_points = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+
+  std::mt19937_64 generator(42);
+  bool ok = RunSparse(sparse_vertices, generator);
+  ok = RunDense(dense_points, generator) && ok;
+  std::cout << (ok ? "results agree" : "results differ") << std::endl;
+  return ok ? 0 : 1;
+}
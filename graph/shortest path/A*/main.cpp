@@ -1,9 +1,10 @@
 #include <cassert>
 #include <iostream>
-#include <queue>
-#include <set>
+#include <string>
 #include <vector>
 
+#include "../../graphs/AStar.h"
+
 const int number4 = 4;
 const int number5 = 5;
 const int number6 = 6;
@@ -58,7 +59,6 @@ class BoardArrangement {
         null_pos_ = i;
       }
     }
-    actions_ = 0;
   }
 
   BoardArrangement() {
@@ -67,15 +67,13 @@ class BoardArrangement {
     }
     bitset_ = final_arrangement;
     null_pos_ = number8;
-    actions_ = 0;
   }
 
   BoardArrangement(const BoardArrangement& other) = default;
 
   BoardArrangement(const BoardArrangement& last, Action action)
       : bitset_(last.bitset_),
-        null_pos_(last.null_pos_),
-        actions_(last.actions_ + 1) {
+        null_pos_(last.null_pos_) {
     int d_coord = 0;
     switch (action) {
       case Action::LEFT:
@@ -119,12 +117,8 @@ class BoardArrangement {
     return (bitset_ >> (number4 * (number8 - index))) & first_digit_mask;
   }
 
-  int Heuristic() const { return HScore() + GScore(); }
-
   int HScore() const { return static_cast<int>(FindManhattanDistance()); }
 
-  int GScore() const { return actions_; }
-
   bool IsActionPossible(Action action) const {
     bool answer = false;
     switch (action) {
@@ -171,6 +165,8 @@ class BoardArrangement {
     return counter % 2 == 0 ? Parity::EVEN : Parity::ODD;
   }
 
+  // Sum over the tiles only: the blank's own distance would overestimate
+  // (one move shifts both it and a tile), which costs A* its optimality
   uint64_t FindManhattanDistance() const {
     uint64_t distance = 0;
     for (uint8_t i = 0; i < number9; ++i) {
@@ -179,101 +175,73 @@ class BoardArrangement {
         auto current = Point2D(i % 3, i / 3);
         auto temp = Point2D::Distance(target, current);
         distance += temp;
-      } else {
-        auto target = Point2D(2, 2);
-        auto current = Point2D(i % 3, i / 3);
-        auto temp = Point2D::Distance(target, current);
-        distance += temp;
       }
     }
 
     return distance;
   }
 
-  bool operator==(const BoardArrangement& rhs) {
+  bool operator==(const BoardArrangement& rhs) const {
     return rhs.bitset_ == bitset_;
   }
 
   bool IsFinal() const { return bitset_ == final_arrangement; }
 
  private:
-  int actions_;
   uint64_t bitset_;
   uint8_t null_pos_;
 };
 
-bool operator<(const BoardArrangement& lhs, const BoardArrangement& rhs) {
-  return (lhs.Heuristic() == rhs.Heuristic()
-              ? lhs.GetBitset() > rhs.GetBitset()
-              : lhs.Heuristic() > rhs.Heuristic());
-}
-
-struct Path {
-  Path(const BoardArrangement& initial) : last(initial) {}
-
-  Path(const Path& path, Action action)
-      : actions(path.actions), last(BoardArrangement(path.last, action)) {
-    actions.push_back(action);
+struct AdjacentArrangements {
+  template <typename Emit>
+  void operator()(const BoardArrangement& current, Emit emit) const {
+    for (auto action :
+         {Action::UP, Action::DOWN, Action::LEFT, Action::RIGHT}) {
+      if (current.IsActionPossible(action)) {
+        emit(action, BoardArrangement(current, action), 1);
+      }
+    }
   }
+};
 
-  std::vector<Action> actions;
-  BoardArrangement last;
+struct ManhattanHeuristic {
+  int operator()(const BoardArrangement& board) const {
+    return board.HScore();
+  }
 };
 
-bool operator<(const Path& lhs, const Path& rhs) { return lhs.last < rhs.last; }
+struct BoardHash {
+  size_t operator()(const BoardArrangement& board) const {
+    return board.GetBitset();
+  }
+};
 
 class TagGameSolver {
  public:
   TagGameSolver() = default;
 
   int FindMinPath(const BoardArrangement& initial, std::string& output_path) {
-    closed_ = std::set<BoardArrangement>();
-    open_ = std::priority_queue<Path>();
-    open_.emplace(initial);
-    while (!open_.empty()) {
-      auto path = open_.top();
-      auto current = path.last;
-      open_.pop();
-      if (closed_.find(current) != closed_.end()) {
-        continue;
-      }
-      if (current.IsFinal()) {
-        GetAnswer(path, output_path);
-        // Output min_path size
-        return current.GScore();
-      }
-      AddAdjacentArrangements(path);
-      closed_.insert(current);
+    auto result = engine_.Search(initial, IsFinal);
+    if (!result.found) {
+      std::cout << "FAIL" << std::endl;
+      return -1;
     }
-    std::cout << "FAIL" << std::endl;
-  }
-
-  void GetAnswer(Path& path, std::string& output_path) {
     output_path = "";
-    for (auto action : path.actions) {
+    for (auto action : result.actions) {
       output_path.push_back(ActionToChar(action));
     }
+    // Output min_path size
+    return result.cost;
   }
 
-  void AddAdjacentArrangements(Path& path) {
-    auto current = path.last;
-    if (current.IsActionPossible(Action::UP)) {
-      open_.emplace(path, Action::UP);
-    }
-    if (current.IsActionPossible(Action::DOWN)) {
-      open_.emplace(path, Action::DOWN);
-    }
-    if (current.IsActionPossible(Action::LEFT)) {
-      open_.emplace(path, Action::LEFT);
-    }
-    if (current.IsActionPossible(Action::RIGHT)) {
-      open_.emplace(path, Action::RIGHT);
-    }
+ private:
+  static bool IsFinal(const BoardArrangement& board) {
+    return board.IsFinal();
   }
 
- private:
-  std::set<BoardArrangement> closed_;
-  std::priority_queue<Path> open_;
+  AStarEngine<BoardArrangement, Action, AdjacentArrangements,
+              ManhattanHeuristic, BoardHash>
+      engine_{AdjacentArrangements(), ManhattanHeuristic()};
 };
 
 int main() {
@@ -0,0 +1,90 @@
+#ifndef COUNT_SHORTEST_PATHS_BIG_UNSIGNED_H
+#define COUNT_SHORTEST_PATHS_BIG_UNSIGNED_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Non-negative integer of any size, with just what path counting needs:
+// addition and printing. Limbs are 32-bit, least significant first, with no
+// leading zero limbs (zero has none).
+class BigUnsigned {
+ public:
+  BigUnsigned() = default;
+
+  BigUnsigned(uint64_t value) {
+    for (; value != 0; value >>= 32) {
+      limbs_.push_back(static_cast<uint32_t>(value));
+    }
+  }
+
+  BigUnsigned& operator+=(const BigUnsigned& other) {
+    if (limbs_.size() < other.limbs_.size()) {
+      limbs_.resize(other.limbs_.size(), 0);
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < limbs_.size(); ++i) {
+      if (i >= other.limbs_.size() && carry == 0) {
+        break;
+      }
+      uint64_t sum = carry + limbs_[i] +
+                     (i < other.limbs_.size() ? other.limbs_[i] : 0);
+      limbs_[i] = static_cast<uint32_t>(sum);
+      carry = sum >> 32;
+    }
+    if (carry != 0) {
+      limbs_.push_back(static_cast<uint32_t>(carry));
+    }
+    return *this;
+  }
+
+  bool operator==(const BigUnsigned& other) const {
+    return limbs_ == other.limbs_;
+  }
+
+  bool operator!=(const BigUnsigned& other) const { return !(*this == other); }
+
+  bool IsZero() const { return limbs_.empty(); }
+
+  // Number of significant bits
+  size_t BitsCount() const {
+    if (limbs_.empty()) {
+      return 0;
+    }
+    return 32 * limbs_.size() - __builtin_clz(limbs_.back());
+  }
+
+  // Decimal
+  std::string ToString() const {
+    if (limbs_.empty()) {
+      return "0";
+    }
+    // Peel off nine decimal digits at a time
+    const uint32_t kChunk = 1000000000;
+    std::vector<uint32_t> rest = limbs_;
+    std::string digits;
+    while (!rest.empty()) {
+      uint64_t remainder = 0;
+      for (size_t i = rest.size(); i-- > 0;) {
+        uint64_t current = (remainder << 32) | rest[i];
+        rest[i] = static_cast<uint32_t>(current / kChunk);
+        remainder = current % kChunk;
+      }
+      while (!rest.empty() && rest.back() == 0) {
+        rest.pop_back();
+      }
+      for (int i = 0; i < 9 && (!rest.empty() || remainder != 0); ++i) {
+        digits.push_back('0' + remainder % 10);
+        remainder /= 10;
+      }
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+  }
+
+ private:
+  std::vector<uint32_t> limbs_;
+};
+
+#endif  // COUNT_SHORTEST_PATHS_BIG_UNSIGNED_H
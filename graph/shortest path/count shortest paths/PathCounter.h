@@ -0,0 +1,208 @@
+#ifndef COUNT_SHORTEST_PATHS_PATH_COUNTER_H
+#define COUNT_SHORTEST_PATHS_PATH_COUNTER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "../../graphs/BreadthFirstSearch.h"
+#include "../dijkstra/ShortestPathEngine.h"
+#include "BigUnsigned.h"
+
+// How counts add up: a Value type, One() for the source and Add(sum, value).
+
+// Exact counts, however large
+struct ExactCounting {
+  using Value = BigUnsigned;
+
+  Value One() const { return 1; }
+
+  void Add(Value& sum, const Value& value) const { sum += value; }
+};
+
+// Counts modulo `modulus`
+struct ModularCounting {
+  using Value = uint64_t;
+
+  explicit ModularCounting(uint64_t modulus = 1000000007) : modulus(modulus) {}
+
+  Value One() const { return 1 % modulus; }
+
+  // Both below modulus, so the sum never wraps around
+  void Add(Value& sum, Value value) const {
+    sum = value >= modulus - sum ? value - (modulus - sum) : sum + value;
+  }
+
+  uint64_t modulus;
+};
+
+// Counts that stop at kSaturated instead of wrapping around: exact below it,
+// and kSaturated means "at least that many"
+struct SaturatingCounting {
+  using Value = uint64_t;
+
+  static constexpr Value kSaturated = std::numeric_limits<Value>::max();
+
+  Value One() const { return 1; }
+
+  void Add(Value& sum, Value value) const {
+    sum = value > kSaturated - sum ? kSaturated : sum + value;
+  }
+};
+
+// Approximate counts: the magnitude of counts up to about 1e308
+struct FloatingCounting {
+  using Value = double;
+
+  Value One() const { return 1; }
+
+  void Add(Value& sum, Value value) const { sum += value; }
+};
+
+template <typename Value>
+struct PathCounts {
+  std::vector<size_t> distance;  // kUnreached if not reached
+  std::vector<Value> count;      // Value() if not reached
+};
+
+// Counts shortest paths from a source to every vertex. Vertices are grouped
+// by distance and the groups are done in order: a vertex pulls the counts
+// of its predecessors on shortest paths, which all lie in earlier groups,
+// so every group is split between threads with nothing shared. Distances
+// come from the parallel BFS engine on an IGraph, or from Dijkstra on a
+// weighted list; weights must be positive, or a predecessor could share
+// its successor's group.
+template <typename Counting>
+class PathCounter {
+ public:
+  using Value = typename Counting::Value;
+
+  explicit PathCounter(const IGraph& graph, Counting counting = Counting(),
+                       size_t num_threads = DefaultThreadsCount())
+      : graph_(&graph),
+        counting_(counting),
+        num_threads_(std::max<size_t>(1, num_threads)) {}
+
+  explicit PathCounter(const WeightedList& list,
+                       Counting counting = Counting(),
+                       size_t num_threads = DefaultThreadsCount())
+      : engine_(std::make_unique<ShortestPathEngine>(list, num_threads)),
+        counting_(counting),
+        num_threads_(std::max<size_t>(1, num_threads)) {
+    // Incoming edges, grouped by head
+    offsets_.assign(list.size() + 1, 0);
+    for (const auto& edges : list) {
+      for (auto [next, weight] : edges) {
+        assert(weight > 0);
+        ++offsets_[next + 1];
+      }
+    }
+    for (size_t vertex = 0; vertex < list.size(); ++vertex) {
+      offsets_[vertex + 1] += offsets_[vertex];
+    }
+    sources_.resize(offsets_.back());
+    weights_.resize(offsets_.back());
+    auto position = std::vector<size_t>(offsets_.begin(), offsets_.end() - 1);
+    for (Vertex vertex = 0; vertex < list.size(); ++vertex) {
+      for (auto [next, weight] : list[vertex]) {
+        sources_[position[next]] = vertex;
+        weights_[position[next]++] = weight;
+      }
+    }
+  }
+
+  // With a target, stops once the target's group is done: only vertices no
+  // farther than the target get their counts
+  PathCounts<Value> Run(Vertex source, Vertex target = kNoVertex) const {
+    PathCounts<Value> result;
+    FindDistances(source, target, result.distance);
+    size_t num_vertices = result.distance.size();
+    result.count.assign(num_vertices, Value());
+    size_t limit = target == kNoVertex ? kUnreached : result.distance[target];
+    if (limit == kUnreached && target != kNoVertex) {
+      return result;
+    }
+
+    std::vector<std::pair<size_t, Vertex>> order;
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (result.distance[vertex] != kUnreached &&
+          result.distance[vertex] <= limit) {
+        order.emplace_back(result.distance[vertex], vertex);
+      }
+    }
+    std::sort(order.begin(), order.end());
+    assert(!order.empty() && order.front().second == source);
+    result.count[source] = counting_.One();
+
+    for (size_t begin = 1, end = 1; begin < order.size(); begin = end) {
+      while (end < order.size() && order[end].first == order[begin].first) {
+        ++end;
+      }
+      // Threads are not worth starting for the many thin groups of
+      // long, narrow graphs
+      size_t num_threads =
+          end - begin >= kMinParallelGroup ? num_threads_ : 1;
+      ParallelFor(begin, end, num_threads,
+                  [&](size_t group_begin, size_t group_end, size_t) {
+                    for (size_t i = group_begin; i < group_end; ++i) {
+                      Pull(order[i].second, result);
+                    }
+                  });
+    }
+    return result;
+  }
+
+ private:
+  static constexpr size_t kMinParallelGroup = 1024;
+
+  static_assert(kUnreached == kInfinity, "both mean no path");
+
+  void FindDistances(Vertex source, Vertex target,
+                     std::vector<size_t>& distance) const {
+    if (engine_ == nullptr) {
+      BFSOptions options;
+      options.num_threads = num_threads_;
+      options.target = target;
+      distance = BreadthFirstSearch(*graph_, options).Run(source).levels;
+    } else {
+      auto workspace = engine_->CreateWorkspace();
+      engine_->FindDistances(source, workspace, distance);
+    }
+  }
+
+  void Pull(Vertex vertex, PathCounts<Value>& result) const {
+    const auto& distance = result.distance;
+    Value count = Value();
+    if (engine_ == nullptr) {
+      for (auto prev : graph_->PrevVertices(vertex)) {
+        if (distance[prev] != kUnreached &&
+            distance[prev] + 1 == distance[vertex]) {
+          counting_.Add(count, result.count[prev]);
+        }
+      }
+    } else {
+      for (size_t i = offsets_[vertex]; i < offsets_[vertex + 1]; ++i) {
+        Vertex prev = sources_[i];
+        if (distance[prev] != kUnreached &&
+            distance[prev] + weights_[i] == distance[vertex]) {
+          counting_.Add(count, result.count[prev]);
+        }
+      }
+    }
+    result.count[vertex] = std::move(count);
+  }
+
+  const IGraph* graph_ = nullptr;
+  std::unique_ptr<ShortestPathEngine> engine_;
+  // Incoming edges of the weighted graph, in CSR form
+  std::vector<size_t> offsets_;
+  std::vector<Vertex> sources_;
+  std::vector<size_t> weights_;
+  Counting counting_;
+  size_t num_threads_;
+};
+
+#endif  // COUNT_SHORTEST_PATHS_PATH_COUNTER_H
@@ -0,0 +1,662 @@
+#include "ContractionHierarchy.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <fstream>
+#include <tuple>
+
+namespace {
+
+// "CHRC" little-endian
+const uint32_t kHierarchyMagic = 0x43524843;
+const uint32_t kHierarchyVersion = 1;
+
+// Witness searches give up after settling this many vertices. A search cut
+// short only misses witnesses, which adds redundant shortcuts but never
+// loses a distance. Priorities are only estimates, so they look less far.
+const size_t kWitnessSettleLimit = 500;
+const size_t kPrioritySettleLimit = 50;
+
+struct HierarchyHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t num_vertices;
+  uint64_t num_upward_edges;
+  uint64_t num_downward_edges;
+};
+
+struct Arc {
+  Vertex other;
+  size_t weight;
+  Vertex middle;
+};
+
+struct Shortcut {
+  Vertex from;
+  Vertex to;
+  size_t weight;
+  Vertex middle;
+};
+
+// Dijkstra on the remaining graph, bounded in distance and settled count
+class WitnessSearch {
+ public:
+  explicit WitnessSearch(size_t num_vertices)
+      : distance_(num_vertices),
+        stamp_(num_vertices, 0),
+        generation_(0),
+        queue_(num_vertices) {}
+
+  // Stops early once every arc in `targets` has its head settled
+  void Run(const std::vector<std::vector<Arc>>& out,
+           const std::vector<char>& contracted, Vertex source, Vertex avoided,
+           const std::vector<Arc>& targets, size_t bound,
+           size_t settle_limit) {
+    queue_.Clear();
+    if (++generation_ == 0) {
+      std::fill(stamp_.begin(), stamp_.end(), 0);
+      generation_ = 1;
+    }
+    SetDistance(source, 0);
+    queue_.Update(source, 0);
+    size_t targets_left = targets.size();
+    for (size_t settled = 0;
+         !queue_.Empty() && settled < settle_limit && targets_left > 0;
+         ++settled) {
+      auto [current, distance] = queue_.Pop();
+      if (distance > bound) {
+        break;
+      }
+      for (const auto& target : targets) {
+        targets_left -= target.other == current ? 1 : 0;
+      }
+      for (const auto& arc : out[current]) {
+        if (arc.other == avoided || contracted[arc.other]) {
+          continue;
+        }
+        size_t candidate = distance + arc.weight;
+        if (candidate < Distance(arc.other)) {
+          SetDistance(arc.other, candidate);
+          queue_.Update(arc.other, candidate);
+        }
+      }
+    }
+  }
+
+  // Length of some path avoiding the excluded vertices; kInfinity if none
+  // was found
+  size_t Distance(Vertex vertex) const {
+    return stamp_[vertex] == generation_ ? distance_[vertex] : kInfinity;
+  }
+
+ private:
+  void SetDistance(Vertex vertex, size_t value) {
+    stamp_[vertex] = generation_;
+    distance_[vertex] = value;
+  }
+
+  std::vector<size_t> distance_;
+  std::vector<uint32_t> stamp_;
+  uint32_t generation_;
+  IndexedDaryHeap<size_t> queue_;
+};
+
+// Node ordering and contraction on a dynamic copy of the graph
+class Contractor {
+ public:
+  Contractor(const WeightedList& list, size_t num_threads)
+      : out_(list.size()),
+        in_(list.size()),
+        contracted_(list.size(), 0),
+        priority_(list.size(), 0),
+        contracted_neighbors_(list.size(), 0),
+        num_threads_(num_threads) {
+    for (Vertex from = 0; from < list.size(); ++from) {
+      for (auto [to, weight] : list[from]) {
+        if (from != to) {
+          AddArc(from, to, weight, ContractionHierarchy::kNoMiddle);
+        }
+      }
+    }
+    for (size_t thread = 0; thread < num_threads_; ++thread) {
+      searches_.emplace_back(list.size());
+    }
+  }
+
+  // Contracts every vertex. order[i] is the vertex of rank i; upward and
+  // downward get the arcs each vertex still had when it was contracted, all
+  // of them to higher ranks: outgoing and incoming respectively.
+  void Run(std::vector<Vertex>& order,
+           std::vector<std::vector<Arc>>& upward,
+           std::vector<std::vector<Arc>>& downward) {
+    size_t num_vertices = out_.size();
+    order.clear();
+    upward.assign(num_vertices, std::vector<Arc>());
+    downward.assign(num_vertices, std::vector<Arc>());
+    auto remaining = std::vector<Vertex>(num_vertices);
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      remaining[vertex] = vertex;
+    }
+    UpdatePriorities(remaining);
+    while (!remaining.empty()) {
+      // Local minima of the priority are pairwise non-adjacent, and
+      // contracting one never changes another's neighborhood
+      auto batch = std::vector<Vertex>();
+      for (auto vertex : remaining) {
+        if (IsLocalMinimum(vertex)) {
+          batch.push_back(vertex);
+        }
+      }
+      for (auto vertex : batch) {
+        contracted_[vertex] = 1;
+        order.push_back(vertex);
+      }
+
+      auto shortcuts = std::vector<std::vector<Shortcut>>(batch.size());
+      ParallelFor(0, batch.size(), num_threads_,
+                  [&](size_t begin, size_t end, size_t thread) {
+                    for (size_t i = begin; i < end; ++i) {
+                      FindShortcuts(batch[i], searches_[thread],
+                                    kWitnessSettleLimit,
+                                    [&](const Shortcut& shortcut) {
+                                      shortcuts[i].push_back(shortcut);
+                                    });
+                    }
+                  });
+
+      auto touched = std::vector<Vertex>();
+      for (size_t i = 0; i < batch.size(); ++i) {
+        Vertex vertex = batch[i];
+        for (const auto& arc : out_[vertex]) {
+          RemoveArc(in_[arc.other], vertex);
+          ++contracted_neighbors_[arc.other];
+          touched.push_back(arc.other);
+        }
+        for (const auto& arc : in_[vertex]) {
+          RemoveArc(out_[arc.other], vertex);
+          ++contracted_neighbors_[arc.other];
+          touched.push_back(arc.other);
+        }
+        upward[vertex] = std::move(out_[vertex]);
+        downward[vertex] = std::move(in_[vertex]);
+        for (const auto& shortcut : shortcuts[i]) {
+          AddArc(shortcut.from, shortcut.to, shortcut.weight,
+                 shortcut.middle);
+        }
+      }
+      std::sort(touched.begin(), touched.end());
+      touched.erase(std::unique(touched.begin(), touched.end()),
+                    touched.end());
+      UpdatePriorities(touched);
+
+      remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                     [&](Vertex vertex) {
+                                       return contracted_[vertex] != 0;
+                                     }),
+                      remaining.end());
+    }
+  }
+
+ private:
+  // Calls emit for each shortcut that contracting vertex requires: one per
+  // in-neighbor a and out-neighbor b with no path a -> b as short that
+  // avoids vertex
+  template <typename Emit>
+  void FindShortcuts(Vertex vertex, WitnessSearch& search, size_t settle_limit,
+                     Emit emit) {
+    size_t max_out = 0;
+    for (const auto& arc : out_[vertex]) {
+      max_out = std::max(max_out, arc.weight);
+    }
+    for (const auto& in_arc : in_[vertex]) {
+      search.Run(out_, contracted_, in_arc.other, vertex, out_[vertex],
+                 in_arc.weight + max_out, settle_limit);
+      for (const auto& out_arc : out_[vertex]) {
+        if (out_arc.other == in_arc.other) {
+          continue;
+        }
+        size_t via = in_arc.weight + out_arc.weight;
+        if (search.Distance(out_arc.other) > via) {
+          emit(Shortcut{in_arc.other, out_arc.other, via, vertex});
+        }
+      }
+    }
+  }
+
+  // Edge difference, plus already contracted neighbors to keep the
+  // contraction spread evenly over the graph
+  void UpdatePriorities(const std::vector<Vertex>& vertices) {
+    ParallelFor(0, vertices.size(), num_threads_,
+                [&](size_t begin, size_t end, size_t thread) {
+                  for (size_t i = begin; i < end; ++i) {
+                    Vertex vertex = vertices[i];
+                    int64_t added = 0;
+                    FindShortcuts(vertex, searches_[thread],
+                                  kPrioritySettleLimit,
+                                  [&](const Shortcut&) { ++added; });
+                    int64_t removed = static_cast<int64_t>(
+                        out_[vertex].size() + in_[vertex].size());
+                    priority_[vertex] =
+                        added - removed +
+                        static_cast<int64_t>(contracted_neighbors_[vertex]);
+                  }
+                });
+  }
+
+  bool Precedes(Vertex lhs, Vertex rhs) const {
+    return std::tie(priority_[lhs], lhs) < std::tie(priority_[rhs], rhs);
+  }
+
+  bool IsLocalMinimum(Vertex vertex) const {
+    for (const auto& arc : out_[vertex]) {
+      if (!Precedes(vertex, arc.other)) {
+        return false;
+      }
+    }
+    for (const auto& arc : in_[vertex]) {
+      if (!Precedes(vertex, arc.other)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Keeps the shorter of parallel arcs
+  void AddArc(Vertex from, Vertex to, size_t weight, Vertex middle) {
+    for (auto& arc : out_[from]) {
+      if (arc.other == to) {
+        if (weight < arc.weight) {
+          arc.weight = weight;
+          arc.middle = middle;
+          for (auto& reverse_arc : in_[to]) {
+            if (reverse_arc.other == from) {
+              reverse_arc.weight = weight;
+              reverse_arc.middle = middle;
+            }
+          }
+        }
+        return;
+      }
+    }
+    out_[from].push_back(Arc{to, weight, middle});
+    in_[to].push_back(Arc{from, weight, middle});
+  }
+
+  static void RemoveArc(std::vector<Arc>& arcs, Vertex other) {
+    for (size_t i = 0; i < arcs.size(); ++i) {
+      if (arcs[i].other == other) {
+        arcs[i] = arcs.back();
+        arcs.pop_back();
+        return;
+      }
+    }
+  }
+
+  std::vector<std::vector<Arc>> out_;
+  std::vector<std::vector<Arc>> in_;
+  std::vector<char> contracted_;
+  std::vector<int64_t> priority_;
+  std::vector<size_t> contracted_neighbors_;
+  size_t num_threads_;
+  std::vector<WitnessSearch> searches_;
+};
+
+template <typename T>
+void WriteArray(std::ofstream& out, const std::vector<T>& array) {
+  out.write(reinterpret_cast<const char*>(array.data()),
+            array.size() * sizeof(T));
+}
+
+template <typename T>
+bool ReadArray(std::ifstream& in, size_t size, std::vector<T>& array) {
+  array.resize(size);
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(array.data()),
+                                    array.size() * sizeof(T)));
+}
+
+}  // namespace
+
+void ContractionHierarchy::Workspace::NextQuery() {
+  forward_.queue.Clear();
+  backward_.queue.Clear();
+  if (++generation_ == 0) {
+    // Stamps wrapped around: old labels could look current again
+    std::fill(forward_.stamp.begin(), forward_.stamp.end(), 0);
+    std::fill(backward_.stamp.begin(), backward_.stamp.end(), 0);
+    generation_ = 1;
+  }
+}
+
+ContractionHierarchy::ContractionHierarchy(const WeightedList& list,
+                                           size_t num_threads)
+    : num_threads_(std::max<size_t>(1, num_threads)) {
+  auto upward = std::vector<std::vector<Arc>>();
+  auto downward = std::vector<std::vector<Arc>>();
+  Contractor(list, num_threads_).Run(order_, upward, downward);
+  rank_.resize(order_.size());
+  for (Vertex rank = 0; rank < order_.size(); ++rank) {
+    rank_[order_[rank]] = rank;
+  }
+  auto pack = [&](std::vector<std::vector<Arc>>& arcs,
+                  Adjacency& adjacency) {
+    adjacency.offsets.assign(1, 0);
+    for (auto vertex : order_) {
+      auto& vertex_arcs = arcs[vertex];
+      for (auto& arc : vertex_arcs) {
+        arc.other = rank_[arc.other];
+        if (arc.middle != kNoMiddle) {
+          arc.middle = rank_[arc.middle];
+        }
+      }
+      std::sort(vertex_arcs.begin(), vertex_arcs.end(),
+                [](const Arc& lhs, const Arc& rhs) {
+                  return lhs.other < rhs.other;
+                });
+      for (const auto& arc : vertex_arcs) {
+        adjacency.targets.push_back(arc.other);
+        adjacency.weights.push_back(arc.weight);
+        adjacency.middles.push_back(arc.middle);
+      }
+      adjacency.offsets.push_back(adjacency.targets.size());
+      std::vector<Arc>().swap(vertex_arcs);
+    }
+  };
+  pack(upward, upward_);
+  pack(downward, downward_);
+  BuildWorkspaces();
+}
+
+void ContractionHierarchy::BuildWorkspaces() {
+  workspaces_.clear();
+  workspaces_.emplace_back(VerticesCount());
+}
+
+std::pair<Vertex, size_t> ContractionHierarchy::Query(
+    Vertex from, Vertex to, Workspace& workspace) const {
+  workspace.NextQuery();
+  uint32_t generation = workspace.generation_;
+  Workspace::Search* searches[] = {&workspace.forward_, &workspace.backward_};
+  const Adjacency* adjacencies[] = {&upward_, &downward_};
+  from = rank_[from];
+  to = rank_[to];
+  searches[0]->SetDistance(from, 0, from, generation);
+  searches[0]->queue.Update(from, 0);
+  searches[1]->SetDistance(to, 0, to, generation);
+  searches[1]->queue.Update(to, 0);
+  Vertex meeting = kNoMiddle;
+  size_t best = kInfinity;
+  while (!searches[0]->queue.Empty() || !searches[1]->queue.Empty()) {
+    size_t side = searches[1]->queue.Empty() ||
+                          (!searches[0]->queue.Empty() &&
+                           searches[0]->queue.MinKey() <=
+                               searches[1]->queue.MinKey())
+                      ? 0
+                      : 1;
+    auto& search = *searches[side];
+    if (search.queue.MinKey() >= best) {
+      // Nothing this side still holds can lead to a shorter path
+      search.queue.Clear();
+      continue;
+    }
+    const auto& other = *searches[1 - side];
+    const auto& adjacency = *adjacencies[side];
+    const auto& opposite = *adjacencies[1 - side];
+    auto [current, distance] = search.queue.Pop();
+    size_t rest = other.Distance(current, generation);
+    if (rest != kInfinity && distance + rest < best) {
+      best = distance + rest;
+      meeting = current;
+    }
+    // Stall on demand: a higher vertex reaching this one more cheaply
+    // proves the label is not a shortest distance, so it cannot be on the
+    // answer's path
+    bool stalled = false;
+    for (size_t i = opposite.offsets[current];
+         i < opposite.offsets[current + 1] && !stalled; ++i) {
+      size_t higher = search.Distance(opposite.targets[i], generation);
+      stalled = higher != kInfinity && higher + opposite.weights[i] < distance;
+    }
+    if (stalled) {
+      continue;
+    }
+    for (size_t i = adjacency.offsets[current];
+         i < adjacency.offsets[current + 1]; ++i) {
+      Vertex next = adjacency.targets[i];
+      size_t candidate = distance + adjacency.weights[i];
+      if (candidate < search.Distance(next, generation)) {
+        search.SetDistance(next, candidate, current, generation);
+        search.queue.Update(next, candidate);
+      }
+    }
+  }
+  return std::make_pair(meeting, best);
+}
+
+size_t ContractionHierarchy::FindMinPath(Vertex from, Vertex to,
+                                         Workspace& workspace) const {
+  return Query(from, to, workspace).second;
+}
+
+size_t ContractionHierarchy::FindMinPath(Vertex from, Vertex to,
+                                         Workspace& workspace,
+                                         std::vector<Vertex>& path) const {
+  path.clear();
+  auto [meeting, distance] = Query(from, to, workspace);
+  if (meeting == kNoMiddle) {
+    return distance;
+  }
+  uint32_t generation = workspace.generation_;
+  const auto& forward = workspace.forward_;
+  const auto& backward = workspace.backward_;
+  assert(forward.stamp[meeting] == generation &&
+         backward.stamp[meeting] == generation);
+  // Climb: from -> meeting over upward edges, collected top-down
+  auto climb = std::vector<Vertex>();
+  for (Vertex vertex = meeting; vertex != rank_[from];
+       vertex = forward.parent[vertex]) {
+    climb.push_back(vertex);
+  }
+  std::reverse(climb.begin(), climb.end());
+  path.push_back(rank_[from]);
+  Vertex previous = rank_[from];
+  for (auto vertex : climb) {
+    Unpack(previous, vertex, FindMiddle(upward_, previous, vertex), path);
+    previous = vertex;
+  }
+  // Descend: meeting -> to over downward edges, stored at their heads
+  for (Vertex vertex = meeting; vertex != rank_[to];) {
+    Vertex next = backward.parent[vertex];
+    Unpack(vertex, next, FindMiddle(downward_, next, vertex), path);
+    vertex = next;
+  }
+  for (auto& vertex : path) {
+    vertex = order_[vertex];
+  }
+  return distance;
+}
+
+size_t ContractionHierarchy::FindMinPath(Vertex from, Vertex to) {
+  return FindMinPath(from, to, workspaces_.front());
+}
+
+std::vector<size_t> ContractionHierarchy::FindMinPaths(
+    const std::vector<std::pair<Vertex, Vertex>>& queries) {
+  size_t num_threads =
+      std::min(num_threads_, std::max<size_t>(1, queries.size()));
+  while (workspaces_.size() < num_threads) {
+    workspaces_.emplace_back(VerticesCount());
+  }
+  auto answers = std::vector<size_t>(queries.size());
+  std::atomic<size_t> next_query(0);
+  ParallelFor(0, num_threads, num_threads, [&](size_t, size_t, size_t thread) {
+    for (size_t query = next_query++; query < queries.size();
+         query = next_query++) {
+      answers[query] = FindMinPath(queries[query].first,
+                                   queries[query].second, workspaces_[thread]);
+    }
+  });
+  return answers;
+}
+
+Vertex ContractionHierarchy::FindMiddle(const Adjacency& adjacency,
+                                        Vertex lower, Vertex higher) const {
+  auto begin = adjacency.targets.begin() + adjacency.offsets[lower];
+  auto end = adjacency.targets.begin() + adjacency.offsets[lower + 1];
+  auto edge = std::lower_bound(begin, end, higher);
+  assert(edge != end && *edge == higher);
+  return adjacency.middles[edge - adjacency.targets.begin()];
+}
+
+void ContractionHierarchy::Unpack(Vertex from, Vertex to, Vertex middle,
+                                  std::vector<Vertex>& path) const {
+  // Shortcuts nest as deep as the hierarchy, so expand with a stack of
+  // pending edges, the leftmost on top
+  auto pending = std::vector<std::tuple<Vertex, Vertex, Vertex>>();
+  pending.emplace_back(from, to, middle);
+  while (!pending.empty()) {
+    auto [edge_from, edge_to, edge_middle] = pending.back();
+    pending.pop_back();
+    if (edge_middle == kNoMiddle) {
+      path.push_back(edge_to);
+      continue;
+    }
+    // The bypassed vertex is below both ends: edge_from -> middle is a
+    // downward edge and middle -> edge_to an upward one
+    pending.emplace_back(edge_middle, edge_to,
+                         FindMiddle(upward_, edge_middle, edge_to));
+    pending.emplace_back(edge_from, edge_middle,
+                         FindMiddle(downward_, edge_middle, edge_from));
+  }
+}
+
+bool ContractionHierarchy::Save(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  HierarchyHeader header = {kHierarchyMagic, kHierarchyVersion,
+                            VerticesCount(), upward_.targets.size(),
+                            downward_.targets.size()};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  WriteArray(out, order_);
+  for (const auto* adjacency : {&upward_, &downward_}) {
+    WriteArray(out, adjacency->offsets);
+    WriteArray(out, adjacency->targets);
+    WriteArray(out, adjacency->weights);
+    WriteArray(out, adjacency->middles);
+  }
+  return static_cast<bool>(out);
+}
+
+bool ContractionHierarchy::Load(const std::string& path,
+                                size_t num_vertices) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return false;
+  }
+  uint64_t file_size = in.tellg();
+  in.seekg(0);
+  HierarchyHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != kHierarchyMagic ||
+      header.version != kHierarchyVersion ||
+      header.num_vertices != num_vertices) {
+    return false;
+  }
+  // The counts must account for the file exactly, which also keeps a
+  // corrupt header from asking for a huge allocation
+  const uint64_t kWord = sizeof(uint64_t);
+  const uint64_t kEdgeBytes = 3 * kWord;  // target, weight, middle
+  if (header.num_upward_edges > file_size / kEdgeBytes ||
+      header.num_downward_edges > file_size / kEdgeBytes ||
+      header.num_vertices > file_size / kWord ||
+      file_size != sizeof(header) + kWord * header.num_vertices +
+                       2 * kWord * (header.num_vertices + 1) +
+                       kEdgeBytes * (header.num_upward_edges +
+                                     header.num_downward_edges)) {
+    return false;
+  }
+  auto order = std::vector<Vertex>();
+  Adjacency upward;
+  Adjacency downward;
+  if (!ReadArray(in, header.num_vertices, order)) {
+    return false;
+  }
+  size_t num_edges[] = {header.num_upward_edges, header.num_downward_edges};
+  Adjacency* adjacencies[] = {&upward, &downward};
+  for (size_t i = 0; i < 2; ++i) {
+    if (!ReadArray(in, header.num_vertices + 1, adjacencies[i]->offsets) ||
+        !ReadArray(in, num_edges[i], adjacencies[i]->targets) ||
+        !ReadArray(in, num_edges[i], adjacencies[i]->weights) ||
+        !ReadArray(in, num_edges[i], adjacencies[i]->middles)) {
+      return false;
+    }
+  }
+  auto rank = std::vector<Vertex>(num_vertices, kNoMiddle);
+  for (Vertex vertex_rank = 0; vertex_rank < num_vertices; ++vertex_rank) {
+    Vertex vertex = order[vertex_rank];
+    if (vertex >= num_vertices || rank[vertex] != kNoMiddle) {
+      return false;
+    }
+    rank[vertex] = vertex_rank;
+  }
+  if (!IsWellFormed(upward, downward, num_vertices)) {
+    return false;
+  }
+  order_ = std::move(order);
+  rank_ = std::move(rank);
+  upward_ = std::move(upward);
+  downward_ = std::move(downward);
+  BuildWorkspaces();
+  return true;
+}
+
+bool ContractionHierarchy::IsWellFormed(const Adjacency& upward,
+                                        const Adjacency& downward,
+                                        size_t num_vertices) {
+  auto has_edge = [](const Adjacency& adjacency, Vertex lower,
+                     Vertex higher) {
+    auto begin = adjacency.targets.begin() + adjacency.offsets[lower];
+    auto end = adjacency.targets.begin() + adjacency.offsets[lower + 1];
+    auto edge = std::lower_bound(begin, end, higher);
+    return edge != end && *edge == higher;
+  };
+  for (const auto* adjacency : {&upward, &downward}) {
+    const auto& offsets = adjacency->offsets;
+    if (offsets.front() != 0 ||
+        offsets.back() != adjacency->targets.size()) {
+      return false;
+    }
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (offsets[vertex] > offsets[vertex + 1]) {
+        return false;
+      }
+    }
+  }
+  for (const auto* adjacency : {&upward, &downward}) {
+    bool is_upward = adjacency == &upward;
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      for (size_t edge = adjacency->offsets[vertex];
+           edge < adjacency->offsets[vertex + 1]; ++edge) {
+        // Targets rank above their vertex, strictly increasing
+        Vertex target = adjacency->targets[edge];
+        if (target <= vertex || target >= num_vertices ||
+            (edge > adjacency->offsets[vertex] &&
+             adjacency->targets[edge - 1] >= target)) {
+          return false;
+        }
+        // A shortcut bypasses a lower vertex, and Unpack needs both of the
+        // edges it replaced
+        Vertex middle = adjacency->middles[edge];
+        Vertex from = is_upward ? vertex : target;
+        Vertex to = is_upward ? target : vertex;
+        if (middle != kNoMiddle &&
+            (middle >= vertex || !has_edge(upward, middle, to) ||
+             !has_edge(downward, middle, from))) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
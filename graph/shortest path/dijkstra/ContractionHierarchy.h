@@ -0,0 +1,145 @@
+#ifndef DIJKSTRA_CONTRACTIONHIERARCHY_H
+#define DIJKSTRA_CONTRACTIONHIERARCHY_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../graphs/Parallel.h"
+#include "../../graphs/PriorityQueues.h"
+#include "Dijkstra.h"
+
+// Contraction hierarchy over a static weighted graph. Preprocessing ranks
+// the vertices by edge difference and contracts them bottom-up, adding a
+// shortcut u -> w whenever the only shortest u -> w path ran through the
+// contracted vertex. Independent vertices (no two adjacent) are contracted
+// together, with their witness searches run in parallel.
+//
+// Vertices are renumbered by rank, and every edge is kept once, at its
+// lower endpoint: upward edges in one CSR, downward edges (reversed) in the
+// other. A query is a Dijkstra from each end that only ever climbs, so it
+// touches a few hundred vertices even on graphs with millions of them.
+class ContractionHierarchy {
+ public:
+  // Middle of an edge that is not a shortcut
+  static constexpr Vertex kNoMiddle = std::numeric_limits<Vertex>::max();
+
+  class Workspace {
+   public:
+    explicit Workspace(size_t num_vertices)
+        : forward_(num_vertices), backward_(num_vertices), generation_(0) {}
+
+   private:
+    friend class ContractionHierarchy;
+
+    struct Search {
+      explicit Search(size_t num_vertices)
+          : distance(num_vertices), parent(num_vertices),
+            stamp(num_vertices, 0), queue(num_vertices) {}
+
+      size_t Distance(Vertex vertex, uint32_t generation) const {
+        return stamp[vertex] == generation ? distance[vertex] : kInfinity;
+      }
+
+      void SetDistance(Vertex vertex, size_t value, Vertex from,
+                       uint32_t generation) {
+        stamp[vertex] = generation;
+        distance[vertex] = value;
+        parent[vertex] = from;
+      }
+
+      std::vector<size_t> distance;
+      // Lower-ranked vertex the label came from
+      std::vector<Vertex> parent;
+      std::vector<uint32_t> stamp;
+      IndexedDaryHeap<size_t> queue;
+    };
+
+    void NextQuery();
+
+    Search forward_;
+    Search backward_;
+    uint32_t generation_;
+  };
+
+  // Empty; fill it with Load
+  ContractionHierarchy() : num_threads_(1) {}
+
+  explicit ContractionHierarchy(const WeightedList& list,
+                                size_t num_threads = DefaultThreadsCount());
+
+  size_t VerticesCount() const { return order_.size(); }
+
+  // Edges of the hierarchy, shortcuts included
+  size_t EdgesCount() const {
+    return upward_.targets.size() + downward_.targets.size();
+  }
+
+  Workspace CreateWorkspace() const { return Workspace(VerticesCount()); }
+
+  // kInfinity if `to` is unreachable. Safe to call concurrently as long as
+  // every thread uses its own workspace.
+  size_t FindMinPath(Vertex from, Vertex to, Workspace& workspace) const;
+
+  // Also unpacks the shortcuts into the full vertex sequence from `from` to
+  // `to`; `path` is left empty if there is none
+  size_t FindMinPath(Vertex from, Vertex to, Workspace& workspace,
+                     std::vector<Vertex>& path) const;
+
+  // Runs on the hierarchy's own first workspace
+  size_t FindMinPath(Vertex from, Vertex to);
+
+  // Answers queries in order; threads pull queries from a shared counter
+  std::vector<size_t> FindMinPaths(
+      const std::vector<std::pair<Vertex, Vertex>>& queries);
+
+  bool Save(const std::string& path) const;
+
+  // False unless the file holds a consistent hierarchy over num_vertices
+  // vertices (those of the graph it is meant to answer queries on)
+  bool Load(const std::string& path, size_t num_vertices);
+
+ private:
+  // Edges at their lower-ranked endpoint, in rank numbering; `middles`
+  // holds the vertex a shortcut bypasses, kNoMiddle for original edges
+  struct Adjacency {
+    std::vector<size_t> offsets;
+    std::vector<Vertex> targets;
+    std::vector<size_t> weights;
+    std::vector<Vertex> middles;
+  };
+
+  // Meeting vertex of the two searches (or kNoMiddle) and the distance
+  std::pair<Vertex, size_t> Query(Vertex from, Vertex to,
+                                  Workspace& workspace) const;
+
+  // Appends the vertices after `from` on the original path of edge
+  // from -> to, in rank numbering
+  void Unpack(Vertex from, Vertex to, Vertex middle,
+              std::vector<Vertex>& path) const;
+
+  // Middle of the edge between lower and higher, given which CSR holds it
+  // (targets are sorted within each vertex)
+  Vertex FindMiddle(const Adjacency& adjacency, Vertex lower,
+                    Vertex higher) const;
+
+  // Offsets, target ranks and shortcut middles all in range, targets
+  // sorted, and every shortcut's two halves present
+  static bool IsWellFormed(const Adjacency& upward,
+                           const Adjacency& downward, size_t num_vertices);
+
+  void BuildWorkspaces();
+
+  // Original vertex of each rank and rank of each original vertex
+  std::vector<Vertex> order_;
+  std::vector<Vertex> rank_;
+  // upward_: edges to higher ranks. downward_: edges from higher ranks,
+  // stored at their head so the backward search climbs it the same way.
+  Adjacency upward_;
+  Adjacency downward_;
+  size_t num_threads_;
+  std::vector<Workspace> workspaces_;
+};
+
+#endif  // DIJKSTRA_CONTRACTIONHIERARCHY_H
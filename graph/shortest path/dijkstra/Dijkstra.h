@@ -0,0 +1,36 @@
+#ifndef DIJKSTRA_DIJKSTRA_H
+#define DIJKSTRA_DIJKSTRA_H
+
+#include <limits>
+#include <tuple>
+#include <vector>
+#include "../../graphs/PriorityQueues.h"
+
+using WeightedList = std::vector<std::vector<std::tuple<Vertex, size_t>>>;
+
+const size_t kInfinity = std::numeric_limits<size_t>::max();
+
+// Dijkstra over an adjacency list with a pluggable priority queue (see
+// graphs/PriorityQueues.h). Returns kInfinity if `to` is unreachable.
+template <typename Queue = IndexedDaryHeap<size_t>>
+size_t FindMinPath(const WeightedList& list, Vertex from, Vertex to) {
+  auto distance = std::vector<size_t>(list.size(), kInfinity);
+  Queue queue(list.size());
+  distance[from] = 0;
+  queue.Update(from, 0);
+  while (!queue.Empty()) {
+    auto [current, key] = queue.Pop();
+    if (Queue::IsLazy && key > distance[current]) {
+      continue;
+    }
+    for (auto [next, weight] : list[current]) {
+      if (distance[current] + weight < distance[next]) {
+        distance[next] = distance[current] + weight;
+        queue.Update(next, distance[next]);
+      }
+    }
+  }
+  return distance[to];
+}
+
+#endif  // DIJKSTRA_DIJKSTRA_H
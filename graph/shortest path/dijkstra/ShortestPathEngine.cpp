@@ -0,0 +1,417 @@
+#include "ShortestPathEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <fstream>
+
+// "LMRK" little-endian
+static constexpr uint32_t kLandmarksMagic = 0x4B524D4C;
+static constexpr uint32_t kLandmarksVersion = 1;
+
+struct LandmarksHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t num_vertices;
+  uint64_t num_landmarks;
+};
+
+void ShortestPathEngine::Workspace::NextQuery() {
+  forward_.queue.Clear();
+  if (backward_) {
+    backward_->queue.Clear();
+  }
+  settled_ = 0;
+  if (++generation_ == 0) {
+    // Stamps wrapped around: old labels could look current again
+    std::fill(forward_.stamp.begin(), forward_.stamp.end(), 0);
+    if (backward_) {
+      std::fill(backward_->stamp.begin(), backward_->stamp.end(), 0);
+    }
+    generation_ = 1;
+  }
+}
+
+ShortestPathEngine::Workspace::Search&
+ShortestPathEngine::Workspace::Backward() {
+  if (!backward_) {
+    // Zeroed stamps never match the current generation, which is > 0
+    backward_ = std::make_unique<Search>(forward_.distance.size());
+  }
+  return *backward_;
+}
+
+ShortestPathEngine::ShortestPathEngine(const WeightedList& list,
+                                       size_t num_threads)
+    : num_threads_(std::max<size_t>(1, num_threads)) {
+  size_t num_vertices = list.size();
+  forward_.offsets.assign(num_vertices + 1, 0);
+  backward_.offsets.assign(num_vertices + 1, 0);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    forward_.offsets[vertex + 1] =
+        forward_.offsets[vertex] + list[vertex].size();
+    for (auto [to, weight] : list[vertex]) {
+      ++backward_.offsets[to + 1];
+    }
+  }
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    backward_.offsets[vertex + 1] += backward_.offsets[vertex];
+  }
+  size_t num_edges = forward_.offsets.back();
+  forward_.targets.reserve(num_edges);
+  forward_.weights.reserve(num_edges);
+  backward_.targets.resize(num_edges);
+  backward_.weights.resize(num_edges);
+  auto fill = std::vector<size_t>(backward_.offsets.begin(),
+                                  backward_.offsets.end() - 1);
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    for (auto [to, weight] : list[vertex]) {
+      forward_.targets.push_back(to);
+      forward_.weights.push_back(weight);
+      backward_.targets[fill[to]] = vertex;
+      backward_.weights[fill[to]++] = weight;
+    }
+  }
+  workspaces_.emplace_back(num_vertices);
+}
+
+size_t ShortestPathEngine::FindMinPath(Vertex from, Vertex to,
+                                       Workspace& workspace,
+                                       QueryMode mode) const {
+  workspace.NextQuery();
+  switch (mode) {
+    case QueryMode::Bidirectional:
+      return Bidirectional(from, to, workspace);
+    case QueryMode::ALT:
+      return ALT(from, to, workspace);
+    default:
+      return Dijkstra(from, to, workspace);
+  }
+}
+
+size_t ShortestPathEngine::FindMinPath(Vertex from, Vertex to,
+                                       QueryMode mode) {
+  return FindMinPath(from, to, workspaces_.front(), mode);
+}
+
+void ShortestPathEngine::FindDistances(Vertex from, Workspace& workspace,
+                                       std::vector<size_t>& distances) const {
+  workspace.NextQuery();
+  // No vertex has this id, so the search runs until the queue is empty
+  Dijkstra(from, std::numeric_limits<Vertex>::max(), workspace);
+  distances.resize(VerticesCount());
+  for (Vertex vertex = 0; vertex < VerticesCount(); ++vertex) {
+    distances[vertex] =
+        workspace.forward_.Distance(vertex, workspace.generation_);
+  }
+}
+
+std::vector<size_t> ShortestPathEngine::FindMinPaths(
+    const std::vector<std::pair<Vertex, Vertex>>& queries, QueryMode mode) {
+  size_t num_threads =
+      std::min(num_threads_, std::max<size_t>(1, queries.size()));
+  while (workspaces_.size() < num_threads) {
+    workspaces_.emplace_back(VerticesCount());
+  }
+  auto answers = std::vector<size_t>(queries.size());
+  std::atomic<size_t> next_query(0);
+  ParallelFor(0, num_threads, num_threads, [&](size_t, size_t, size_t thread) {
+    for (size_t query = next_query++; query < queries.size();
+         query = next_query++) {
+      answers[query] =
+          FindMinPath(queries[query].first, queries[query].second,
+                      workspaces_[thread], mode);
+    }
+  });
+  return answers;
+}
+
+size_t ShortestPathEngine::Dijkstra(Vertex from, Vertex to,
+                                    Workspace& workspace) const {
+  uint32_t generation = workspace.generation_;
+  auto& search = workspace.forward_;
+  search.SetDistance(from, 0, generation);
+  search.queue.Update(from, 0);
+  while (!search.queue.Empty()) {
+    auto [current, distance] = search.queue.Pop();
+    ++workspace.settled_;
+    if (current == to) {
+      return distance;
+    }
+    for (size_t i = forward_.offsets[current];
+         i < forward_.offsets[current + 1]; ++i) {
+      Vertex next = forward_.targets[i];
+      size_t candidate = distance + forward_.weights[i];
+      if (candidate < search.Distance(next, generation)) {
+        search.SetDistance(next, candidate, generation);
+        search.queue.Update(next, candidate);
+      }
+    }
+  }
+  return kInfinity;
+}
+
+size_t ShortestPathEngine::Bidirectional(Vertex from, Vertex to,
+                                         Workspace& workspace) const {
+  uint32_t generation = workspace.generation_;
+  Workspace::Search* searches[] = {&workspace.forward_,
+                                   &workspace.Backward()};
+  const Adjacency* adjacencies[] = {&forward_, &backward_};
+  searches[0]->SetDistance(from, 0, generation);
+  searches[0]->queue.Update(from, 0);
+  searches[1]->SetDistance(to, 0, generation);
+  searches[1]->queue.Update(to, 0);
+  // Length of the best path through a vertex labeled from both sides. When
+  // one side runs dry every path has been seen, since the other side's
+  // source was labeled from the start.
+  size_t best = from == to ? 0 : kInfinity;
+  while (!searches[0]->queue.Empty() && !searches[1]->queue.Empty()) {
+    size_t forward_key = searches[0]->queue.MinKey();
+    size_t backward_key = searches[1]->queue.MinKey();
+    if (forward_key + backward_key >= best) {
+      break;
+    }
+    size_t side = forward_key <= backward_key ? 0 : 1;
+    auto& search = *searches[side];
+    const auto& other = *searches[1 - side];
+    const auto& adjacency = *adjacencies[side];
+    auto [current, distance] = search.queue.Pop();
+    ++workspace.settled_;
+    for (size_t i = adjacency.offsets[current];
+         i < adjacency.offsets[current + 1]; ++i) {
+      Vertex next = adjacency.targets[i];
+      size_t candidate = distance + adjacency.weights[i];
+      if (candidate < search.Distance(next, generation)) {
+        search.SetDistance(next, candidate, generation);
+        search.queue.Update(next, candidate);
+        size_t rest = other.Distance(next, generation);
+        if (rest != kInfinity) {
+          best = std::min(best, candidate + rest);
+        }
+      }
+    }
+  }
+  return best;
+}
+
+size_t ShortestPathEngine::ALT(Vertex from, Vertex to,
+                               Workspace& workspace) const {
+  assert(LandmarksCount() > 0);
+  uint32_t generation = workspace.generation_;
+  auto& search = workspace.forward_;
+  // Keys are distance plus lower bound; the bound is consistent, so each
+  // vertex is still settled once and the target pops with its exact distance
+  search.SetDistance(from, 0, generation);
+  search.queue.Update(from, LowerBound(from, to));
+  while (!search.queue.Empty()) {
+    Vertex current = search.queue.Pop().first;
+    ++workspace.settled_;
+    size_t distance = search.Distance(current, generation);
+    if (current == to) {
+      return distance;
+    }
+    for (size_t i = forward_.offsets[current];
+         i < forward_.offsets[current + 1]; ++i) {
+      Vertex next = forward_.targets[i];
+      size_t candidate = distance + forward_.weights[i];
+      if (candidate < search.Distance(next, generation)) {
+        search.SetDistance(next, candidate, generation);
+        search.queue.Update(next, candidate + LowerBound(next, to));
+      }
+    }
+  }
+  return kInfinity;
+}
+
+size_t ShortestPathEngine::LowerBound(Vertex vertex, Vertex target) const {
+  size_t num_landmarks = LandmarksCount();
+  const size_t* from_vertex = &from_landmark_[vertex * num_landmarks];
+  const size_t* from_target = &from_landmark_[target * num_landmarks];
+  const size_t* to_vertex = &to_landmark_[vertex * num_landmarks];
+  const size_t* to_target = &to_landmark_[target * num_landmarks];
+  size_t bound = 0;
+  for (size_t i = 0; i < num_landmarks; ++i) {
+    // d(L, t) <= d(L, v) + d(v, t) and d(v, L) <= d(v, t) + d(t, L); a
+    // landmark that misses either end gives no bound
+    if (from_target[i] != kInfinity && from_vertex[i] != kInfinity &&
+        from_target[i] > from_vertex[i]) {
+      bound = std::max(bound, from_target[i] - from_vertex[i]);
+    }
+    if (to_vertex[i] != kInfinity && to_target[i] != kInfinity &&
+        to_vertex[i] > to_target[i]) {
+      bound = std::max(bound, to_vertex[i] - to_target[i]);
+    }
+  }
+  return bound;
+}
+
+void ShortestPathEngine::FullDijkstra(const Adjacency& adjacency,
+                                      Vertex source,
+                                      std::vector<size_t>& distance) const {
+  distance.assign(VerticesCount(), kInfinity);
+  IndexedDaryHeap<size_t> queue(VerticesCount());
+  distance[source] = 0;
+  queue.Update(source, 0);
+  while (!queue.Empty()) {
+    auto [current, current_distance] = queue.Pop();
+    for (size_t i = adjacency.offsets[current];
+         i < adjacency.offsets[current + 1]; ++i) {
+      Vertex next = adjacency.targets[i];
+      if (current_distance + adjacency.weights[i] < distance[next]) {
+        distance[next] = current_distance + adjacency.weights[i];
+        queue.Update(next, distance[next]);
+      }
+    }
+  }
+}
+
+void ShortestPathEngine::PreprocessLandmarks(size_t num_landmarks) {
+  size_t num_vertices = VerticesCount();
+  num_landmarks = std::min(num_landmarks, num_vertices);
+  landmarks_.clear();
+  from_landmark_.assign(num_vertices * num_landmarks, kInfinity);
+  to_landmark_.assign(num_vertices * num_landmarks, kInfinity);
+  if (num_landmarks == 0) {
+    return;
+  }
+  // Farthest-point selection: each landmark maximizes the distance to the
+  // nearest one picked so far, which spreads them over the graph's rim
+  auto nearest = std::vector<size_t>(num_vertices, kInfinity);
+  auto distance = std::vector<size_t>();
+  // Start from a vertex of maximum degree, which sits in a big component
+  // even when vertex 0 is a stray one
+  Vertex start = 0;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (forward_.offsets[vertex + 1] - forward_.offsets[vertex] >
+        forward_.offsets[start + 1] - forward_.offsets[start]) {
+      start = vertex;
+    }
+  }
+  FullDijkstra(forward_, start, distance);
+  Vertex next_landmark = start;
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (distance[vertex] != kInfinity &&
+        distance[vertex] > distance[next_landmark]) {
+      next_landmark = vertex;
+    }
+  }
+  for (size_t i = 0; i < num_landmarks; ++i) {
+    landmarks_.push_back(next_landmark);
+    FullDijkstra(forward_, next_landmark, distance);
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      from_landmark_[vertex * num_landmarks + i] = distance[vertex];
+      nearest[vertex] = std::min(nearest[vertex], distance[vertex]);
+    }
+    FullDijkstra(backward_, next_landmark, distance);
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      to_landmark_[vertex * num_landmarks + i] = distance[vertex];
+    }
+    // Only vertices the landmarks reach are candidates: an unreached one is
+    // most likely a stray vertex or a small island, and a landmark there
+    // bounds nothing in the part of the graph the queries run in
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      if (nearest[vertex] != kInfinity &&
+          nearest[vertex] > nearest[next_landmark]) {
+        next_landmark = vertex;
+      }
+    }
+  }
+}
+
+bool ShortestPathEngine::SaveLandmarks(const std::string& path) const {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return false;
+  }
+  LandmarksHeader header = {kLandmarksMagic, kLandmarksVersion,
+                            VerticesCount(), LandmarksCount()};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(landmarks_.data()),
+            landmarks_.size() * sizeof(Vertex));
+  out.write(reinterpret_cast<const char*>(from_landmark_.data()),
+            from_landmark_.size() * sizeof(size_t));
+  out.write(reinterpret_cast<const char*>(to_landmark_.data()),
+            to_landmark_.size() * sizeof(size_t));
+  return static_cast<bool>(out);
+}
+
+bool ShortestPathEngine::LoadLandmarks(const std::string& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return false;
+  }
+  uint64_t file_size = in.tellg();
+  in.seekg(0);
+  LandmarksHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      header.magic != kLandmarksMagic ||
+      header.version != kLandmarksVersion ||
+      header.num_vertices != VerticesCount() ||
+      header.num_landmarks > VerticesCount()) {
+    return false;
+  }
+  // The counts must account for the file exactly, which also keeps a
+  // corrupt header from asking for a huge allocation
+  const uint64_t kWord = sizeof(uint64_t);
+  uint64_t payload = file_size - sizeof(header);
+  if (header.num_landmarks != 0 &&
+      header.num_vertices > payload / kWord / 2 / header.num_landmarks) {
+    return false;
+  }
+  if (payload != kWord * header.num_landmarks *
+                     (1 + 2 * header.num_vertices)) {
+    return false;
+  }
+  auto landmarks = std::vector<Vertex>(header.num_landmarks);
+  auto from_landmark =
+      std::vector<size_t>(header.num_vertices * header.num_landmarks);
+  auto to_landmark = std::vector<size_t>(from_landmark.size());
+  in.read(reinterpret_cast<char*>(landmarks.data()),
+          landmarks.size() * sizeof(Vertex));
+  in.read(reinterpret_cast<char*>(from_landmark.data()),
+          from_landmark.size() * sizeof(size_t));
+  in.read(reinterpret_cast<char*>(to_landmark.data()),
+          to_landmark.size() * sizeof(size_t));
+  if (!in || !AreLandmarksValid(landmarks, from_landmark, to_landmark)) {
+    return false;
+  }
+  landmarks_ = std::move(landmarks);
+  from_landmark_ = std::move(from_landmark);
+  to_landmark_ = std::move(to_landmark);
+  return true;
+}
+
+bool ShortestPathEngine::AreLandmarksValid(
+    const std::vector<Vertex>& landmarks,
+    const std::vector<size_t>& from_landmark,
+    const std::vector<size_t>& to_landmark) const {
+  size_t num_landmarks = landmarks.size();
+  for (size_t i = 0; i < num_landmarks; ++i) {
+    if (landmarks[i] >= VerticesCount() ||
+        from_landmark[landmarks[i] * num_landmarks + i] != 0 ||
+        to_landmark[landmarks[i] * num_landmarks + i] != 0) {
+      return false;
+    }
+  }
+  // For every edge (from, to, weight): d(L, to) <= d(L, from) + weight and
+  // d(from, L) <= weight + d(to, L), where reachable ends stay reachable
+  auto fits = [](size_t head, size_t tail, size_t weight) {
+    return tail == kInfinity ||
+           (head != kInfinity && head - std::min(head, tail) <= weight);
+  };
+  for (Vertex from = 0; from < VerticesCount(); ++from) {
+    for (size_t edge = forward_.offsets[from];
+         edge < forward_.offsets[from + 1]; ++edge) {
+      Vertex to = forward_.targets[edge];
+      size_t weight = forward_.weights[edge];
+      for (size_t i = 0; i < num_landmarks; ++i) {
+        if (!fits(from_landmark[to * num_landmarks + i],
+                  from_landmark[from * num_landmarks + i], weight) ||
+            !fits(to_landmark[from * num_landmarks + i],
+                  to_landmark[to * num_landmarks + i], weight)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,148 @@
+#ifndef DIJKSTRA_SHORTESTPATHENGINE_H
+#define DIJKSTRA_SHORTESTPATHENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../graphs/Parallel.h"
+#include "../../graphs/PriorityQueues.h"
+#include "Dijkstra.h"
+
+enum class QueryMode {
+  // Plain Dijkstra with early exit
+  Dijkstra,
+  // Dijkstra from both ends, stopping once the two frontiers' keys add up
+  // to the best meeting point found
+  Bidirectional,
+  // A* with landmark lower bounds (requires PreprocessLandmarks or
+  // LoadLandmarks)
+  ALT
+};
+
+// Point-to-point shortest path service over a static graph. The graph is
+// packed into weighted CSR arrays (forward and reverse) once; every query
+// runs on a Workspace whose distance labels are generation-stamped, so a
+// query costs only what it touches, and stops as soon as the answer is
+// known.
+class ShortestPathEngine {
+ public:
+  class Workspace {
+   public:
+    explicit Workspace(size_t num_vertices)
+        : forward_(num_vertices), generation_(0), settled_(0) {}
+
+    // Vertices settled by the last query
+    size_t SettledCount() const { return settled_; }
+
+   private:
+    friend class ShortestPathEngine;
+
+    struct Search {
+      explicit Search(size_t num_vertices)
+          : distance(num_vertices), stamp(num_vertices, 0),
+            queue(num_vertices) {}
+
+      size_t Distance(Vertex vertex, uint32_t generation) const {
+        return stamp[vertex] == generation ? distance[vertex] : kInfinity;
+      }
+
+      void SetDistance(Vertex vertex, size_t value, uint32_t generation) {
+        stamp[vertex] = generation;
+        distance[vertex] = value;
+      }
+
+      std::vector<size_t> distance;
+      std::vector<uint32_t> stamp;
+      IndexedDaryHeap<size_t> queue;
+    };
+
+    void NextQuery();
+
+    // Allocated on the first bidirectional query
+    Search& Backward();
+
+    Search forward_;
+    std::unique_ptr<Search> backward_;
+    uint32_t generation_;
+    size_t settled_;
+  };
+
+  explicit ShortestPathEngine(const WeightedList& list,
+                              size_t num_threads = DefaultThreadsCount());
+
+  size_t VerticesCount() const { return forward_.offsets.size() - 1; }
+
+  Workspace CreateWorkspace() const { return Workspace(VerticesCount()); }
+
+  // kInfinity if `to` is unreachable. Safe to call concurrently as long as
+  // every thread uses its own workspace.
+  size_t FindMinPath(Vertex from, Vertex to, Workspace& workspace,
+                     QueryMode mode = QueryMode::Dijkstra) const;
+
+  // Runs on the engine's own first workspace
+  size_t FindMinPath(Vertex from, Vertex to,
+                     QueryMode mode = QueryMode::Dijkstra);
+
+  // Distance from `from` to every vertex, kInfinity where unreachable
+  void FindDistances(Vertex from, Workspace& workspace,
+                     std::vector<size_t>& distances) const;
+
+  // Answers queries in order; threads pull queries from a shared counter
+  std::vector<size_t> FindMinPaths(
+      const std::vector<std::pair<Vertex, Vertex>>& queries,
+      QueryMode mode = QueryMode::Dijkstra);
+
+  // Picks landmarks by farthest-point selection and stores distances from
+  // and to each of them
+  void PreprocessLandmarks(size_t num_landmarks);
+
+  size_t LandmarksCount() const { return landmarks_.size(); }
+
+  const std::vector<Vertex>& Landmarks() const { return landmarks_; }
+
+  bool SaveLandmarks(const std::string& path) const;
+
+  // Fails if the file was made for a graph with another vertex count, is
+  // truncated, or holds distances that could make ALT inexact
+  bool LoadLandmarks(const std::string& path);
+
+ private:
+  struct Adjacency {
+    std::vector<size_t> offsets;
+    std::vector<Vertex> targets;
+    std::vector<size_t> weights;
+  };
+
+  size_t Dijkstra(Vertex from, Vertex to, Workspace& workspace) const;
+
+  size_t Bidirectional(Vertex from, Vertex to, Workspace& workspace) const;
+
+  size_t ALT(Vertex from, Vertex to, Workspace& workspace) const;
+
+  // Triangle inequality bound on dist(vertex, target)
+  size_t LowerBound(Vertex vertex, Vertex target) const;
+
+  void FullDijkstra(const Adjacency& adjacency, Vertex source,
+                    std::vector<size_t>& distance) const;
+
+  // Landmarks in range, each at distance 0 from itself, and no edge that
+  // violates the triangle inequality: then every LowerBound is a
+  // consistent lower bound, even if the distances are not exact
+  bool AreLandmarksValid(const std::vector<Vertex>& landmarks,
+                         const std::vector<size_t>& from_landmark,
+                         const std::vector<size_t>& to_landmark) const;
+
+  Adjacency forward_;
+  Adjacency backward_;
+  size_t num_threads_;
+  // One per worker thread, kept between batches
+  std::vector<Workspace> workspaces_;
+  std::vector<Vertex> landmarks_;
+  // Indexed [vertex * LandmarksCount() + landmark]
+  std::vector<size_t> from_landmark_;
+  std::vector<size_t> to_landmark_;
+};
+
+#endif  // DIJKSTRA_SHORTESTPATHENGINE_H
@@ -0,0 +1,249 @@
+// Times FindMinPath with every queue from graphs/PriorityQueues.h against
+// the original std::set erase/insert implementation, then the
+// ShortestPathEngine query modes (with the vertices each one settles) and
+// the contraction hierarchy. The hierarchy is also saved, loaded back and
+// queried again, unpacking every path and checking its weight.
+//
+// Usage: benchmark [grid_side] [num_queries] [num_landmarks]
+// The input is a road-like grid: grid_side^2 vertices, a fifth of the
+// streets missing, occasional diagonals, integer weights in [1, 1000].
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include "../ContractionHierarchy.h"
+#include "../Dijkstra.h"
+#include "../ShortestPathEngine.h"
+
+struct DijkstraVertexInfo {
+  DijkstraVertexInfo()
+      : visited(false), is_infinity(true), is_in_queue(false) {}
+  bool visited;
+  bool is_infinity;
+  bool is_in_queue;
+  size_t min_way;
+};
+
+void Relax(std::vector<DijkstraVertexInfo>& info, Vertex next, Vertex current,
+           size_t weight) {
+  if (info[next].is_infinity) {
+    info[next].min_way = info[current].min_way + weight;
+    info[next].is_infinity = false;
+  } else {
+    info[next].min_way =
+        std::min(info[current].min_way + weight, info[next].min_way);
+  }
+}
+
+// The set-based version FindMinPath used to be, kept as the baseline
+size_t FindMinPathSet(const WeightedList& list, Vertex from, Vertex to) {
+  std::vector<DijkstraVertexInfo> info(list.size());
+  size_t visited_cnt = 0;
+
+  auto comparator = [&](const Vertex& lhs, const Vertex& rhs) {
+    return info[lhs].min_way == info[rhs].min_way
+               ? lhs < rhs
+               : info[lhs].min_way < info[rhs].min_way;
+  };
+  auto weights = std::set<Vertex, decltype(comparator)>(comparator);
+
+  info[from].min_way = 0;
+  weights.insert(from);
+  info[from].is_infinity = false;
+  info[from].is_in_queue = true;
+
+  while (visited_cnt < list.size() && !weights.empty()) {
+    Vertex current = *weights.begin();
+    weights.erase(current);
+    for (auto [next, weight] : list[current]) {
+      if (!info[next].visited) {
+        if (info[next].is_in_queue) {
+          weights.erase(next);
+        }
+        Relax(info, next, current, weight);
+        if (!info[next].is_in_queue) {
+          info[next].is_in_queue = true;
+        }
+        weights.insert(next);
+      }
+    }
+    ++visited_cnt;
+    info[current].visited = true;
+  }
+  return info[to].is_infinity ? kInfinity : info[to].min_way;
+}
+
+WeightedList RoadLikeGrid(size_t side, std::mt19937_64& generator) {
+  WeightedList list(side * side);
+  std::bernoulli_distribution keep(0.8);
+  std::bernoulli_distribution diagonal(0.05);
+  std::uniform_int_distribution<size_t> weight(1, 1000);
+  auto add = [&](Vertex from, Vertex to) {
+    size_t edge_weight = weight(generator);
+    list[from].emplace_back(to, edge_weight);
+    list[to].emplace_back(from, edge_weight);
+  };
+  for (size_t row = 0; row < side; ++row) {
+    for (size_t column = 0; column < side; ++column) {
+      Vertex vertex = row * side + column;
+      if (column + 1 < side && keep(generator)) {
+        add(vertex, vertex + 1);
+      }
+      if (row + 1 < side && keep(generator)) {
+        add(vertex, vertex + side);
+      }
+      if (row + 1 < side && column + 1 < side && diagonal(generator)) {
+        add(vertex, vertex + side + 1);
+      }
+    }
+  }
+  return list;
+}
+
+template <typename Function>
+double Measure(const std::string& name, Function find_min_path,
+               const WeightedList& list,
+               const std::vector<std::pair<Vertex, Vertex>>& queries,
+               std::vector<size_t>& answers) {
+  auto start = std::chrono::steady_clock::now();
+  answers.clear();
+  for (auto [from, to] : queries) {
+    answers.push_back(find_min_path(list, from, to));
+  }
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  std::cout << name << ": " << seconds << " s" << std::endl;
+  return seconds;
+}
+
+int main(int argc, char** argv) {
+  size_t side = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+  size_t num_queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+  size_t num_landmarks = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+
+  std::mt19937_64 generator(42);
+  WeightedList list = RoadLikeGrid(side, generator);
+  std::uniform_int_distribution<Vertex> vertex(0, list.size() - 1);
+  auto queries = std::vector<std::pair<Vertex, Vertex>>();
+  for (size_t i = 0; i < num_queries; ++i) {
+    queries.emplace_back(vertex(generator), vertex(generator));
+  }
+  std::cout << list.size() << " vertices, " << num_queries << " queries"
+            << std::endl;
+
+  std::vector<size_t> expected;
+  std::vector<size_t> answers;
+  double baseline =
+      Measure("std::set", FindMinPathSet, list, queries, expected);
+  bool ok = true;
+  auto compare = [&](const std::string& name, double seconds) {
+    std::cout << "  speedup x" << baseline / seconds << std::endl;
+    if (answers != expected) {
+      std::cout << "  " << name << " disagrees with std::set" << std::endl;
+      ok = false;
+    }
+  };
+  compare("IndexedDaryHeap<2>",
+          Measure("IndexedDaryHeap<2>",
+                  FindMinPath<IndexedDaryHeap<size_t, 2>>, list, queries,
+                  answers));
+  compare("IndexedDaryHeap<4>",
+          Measure("IndexedDaryHeap<4>",
+                  FindMinPath<IndexedDaryHeap<size_t, 4>>, list, queries,
+                  answers));
+  compare("RadixHeap", Measure("RadixHeap", FindMinPath<RadixHeap<size_t>>,
+                               list, queries, answers));
+  compare("LazyBinaryHeap",
+          Measure("LazyBinaryHeap", FindMinPath<LazyBinaryHeap<size_t>>, list,
+                  queries, answers));
+
+  ShortestPathEngine engine(list, 1);
+  auto start = std::chrono::steady_clock::now();
+  engine.PreprocessLandmarks(num_landmarks);
+  std::cout << num_landmarks << " landmarks: "
+            << std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count()
+            << " s" << std::endl;
+  auto workspace = engine.CreateWorkspace();
+  auto measure_mode = [&](const std::string& name, QueryMode mode) {
+    size_t settled = 0;
+    compare(name, Measure(name,
+                          [&](const WeightedList&, Vertex from, Vertex to) {
+                            size_t distance =
+                                engine.FindMinPath(from, to, workspace, mode);
+                            settled += workspace.SettledCount();
+                            return distance;
+                          },
+                          list, queries, answers));
+    std::cout << "  settled " << settled / std::max<size_t>(1, num_queries)
+              << " vertices per query" << std::endl;
+  };
+  measure_mode("Engine Dijkstra", QueryMode::Dijkstra);
+  measure_mode("Engine Bidirectional", QueryMode::Bidirectional);
+  measure_mode("Engine ALT", QueryMode::ALT);
+
+  start = std::chrono::steady_clock::now();
+  ContractionHierarchy hierarchy(list);
+  std::cout << "Contraction: "
+            << std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - start)
+                   .count()
+            << " s, " << hierarchy.EdgesCount() << " edges" << std::endl;
+  auto hierarchy_workspace = hierarchy.CreateWorkspace();
+  compare("ContractionHierarchy",
+          Measure("ContractionHierarchy",
+                  [&](const WeightedList&, Vertex from, Vertex to) {
+                    return hierarchy.FindMinPath(from, to,
+                                                 hierarchy_workspace);
+                  },
+                  list, queries, answers));
+
+  // Save/Load round trip: the loaded hierarchy must give the same
+  // distances, and every unpacked path must add up to its distance
+  const std::string kHierarchyPath = "benchmark.ch";
+  ContractionHierarchy loaded;
+  if (!hierarchy.Save(kHierarchyPath) ||
+      loaded.Load(kHierarchyPath, list.size() + 1) ||
+      !loaded.Load(kHierarchyPath, list.size())) {
+    std::cout << "ContractionHierarchy Save/Load failed" << std::endl;
+    ok = false;
+  } else {
+    auto loaded_workspace = loaded.CreateWorkspace();
+    std::vector<Vertex> path;
+    compare("Loaded hierarchy, unpacked",
+            Measure("Loaded hierarchy, unpacked",
+                    [&](const WeightedList& list, Vertex from, Vertex to) {
+                      size_t distance =
+                          loaded.FindMinPath(from, to, loaded_workspace, path);
+                      if (distance == kInfinity) {
+                        return path.empty() ? distance : 0;
+                      }
+                      if (path.front() != from || path.back() != to) {
+                        return kInfinity;
+                      }
+                      size_t length = 0;
+                      for (size_t i = 0; i + 1 < path.size(); ++i) {
+                        size_t edge = kInfinity;
+                        for (auto [next, weight] : list[path[i]]) {
+                          if (next == path[i + 1]) {
+                            edge = std::min(edge, weight);
+                          }
+                        }
+                        if (edge == kInfinity) {
+                          return kInfinity;
+                        }
+                        length += edge;
+                      }
+                      return length == distance ? distance : kInfinity;
+                    },
+                    list, queries, answers));
+  }
+  std::remove(kHierarchyPath.c_str());
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+#include "FloydWarshall.h"
+#include <algorithm>
+#include <cassert>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t kTile = TiledMatrix::kTile;
+
+// through + length, where through is reachable; saturates at the int32
+// range and keeps kUnreachable. Signed overflow is where both operands
+// differ in sign from the wrapped sum. Only 32-bit selects, so the scalar
+// loops still vectorize.
+inline int32_t PathLength(int32_t through, int32_t length) {
+  auto sum = static_cast<int32_t>(static_cast<uint32_t>(through) +
+                                  static_cast<uint32_t>(length));
+  int32_t saturated = (through >> 31) ^ kUnreachable;
+  sum = ((through ^ sum) & (length ^ sum)) < 0 ? saturated : sum;
+  return length == kUnreachable ? kUnreachable : sum;
+}
+
+#ifdef __AVX2__
+// PathLength on eight lanes
+inline __m256i PathLength(__m256i through, __m256i lengths) {
+  const __m256i unreachable = _mm256_set1_epi32(kUnreachable);
+  __m256i sum = _mm256_add_epi32(through, lengths);
+  __m256i overflow = _mm256_srai_epi32(
+      _mm256_and_si256(_mm256_xor_si256(through, sum),
+                       _mm256_xor_si256(lengths, sum)),
+      31);
+  __m256i saturated =
+      _mm256_xor_si256(_mm256_srai_epi32(through, 31), unreachable);
+  sum = _mm256_blendv_epi8(sum, saturated, overflow);
+  return _mm256_blendv_epi8(sum, unreachable,
+                            _mm256_cmpeq_epi32(lengths, unreachable));
+}
+#endif
+
+// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) with k outermost, so tiles may
+// alias each other. With hops, improved cells take the hop of (i, k). Row k
+// of b is copied out first; it can only change through a negative cycle.
+void RelaxTile(TiledMatrix& distances, TiledMatrix* next_hops, size_t row,
+               size_t column, size_t middle) {
+  size_t stride = distances.Stride();
+  int32_t* c = distances.Tile(row, column);
+  const int32_t* a = distances.Tile(row, middle);
+  const int32_t* b = distances.Tile(middle, column);
+  int32_t* c_hops = next_hops ? next_hops->Tile(row, column) : nullptr;
+  const int32_t* a_hops = next_hops ? next_hops->Tile(row, middle) : nullptr;
+  alignas(64) int32_t b_row[kTile];
+  for (size_t k = 0; k < kTile; ++k) {
+    std::copy(b + k * stride, b + k * stride + kTile, b_row);
+    for (size_t i = 0; i < kTile; ++i) {
+      int32_t through = a[i * stride + k];
+      if (through == kUnreachable) {
+        continue;
+      }
+      int32_t* c_row = c + i * stride;
+      if (c_hops == nullptr) {
+        size_t j = 0;
+#ifdef __AVX2__
+        __m256i through_lanes = _mm256_set1_epi32(through);
+        for (; j < kTile; j += 8) {
+          auto cell = reinterpret_cast<__m256i*>(c_row + j);
+          __m256i candidate = PathLength(
+              through_lanes,
+              _mm256_load_si256(reinterpret_cast<const __m256i*>(b_row + j)));
+          _mm256_store_si256(
+              cell, _mm256_min_epi32(_mm256_load_si256(cell), candidate));
+        }
+#endif
+        for (; j < kTile; ++j) {
+          c_row[j] = std::min(c_row[j], PathLength(through, b_row[j]));
+        }
+        continue;
+      }
+      int32_t hop = a_hops[i * stride + k];
+      int32_t* hop_row = c_hops + i * stride;
+      size_t j = 0;
+#ifdef __AVX2__
+      __m256i through_lanes = _mm256_set1_epi32(through);
+      __m256i hop_lanes = _mm256_set1_epi32(hop);
+      for (; j < kTile; j += 8) {
+        auto cell = reinterpret_cast<__m256i*>(c_row + j);
+        auto hop_cell = reinterpret_cast<__m256i*>(hop_row + j);
+        __m256i candidate = PathLength(
+            through_lanes,
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(b_row + j)));
+        __m256i current = _mm256_load_si256(cell);
+        __m256i improved = _mm256_cmpgt_epi32(current, candidate);
+        _mm256_store_si256(cell, _mm256_min_epi32(current, candidate));
+        _mm256_store_si256(hop_cell,
+                           _mm256_blendv_epi8(_mm256_load_si256(hop_cell),
+                                              hop_lanes, improved));
+      }
+#endif
+#ifndef __AVX2__
+      // Through local copies, which the compiler knows do not alias
+      int32_t cells[kTile];
+      int32_t hops[kTile];
+      std::copy(c_row, c_row + kTile, cells);
+      std::copy(hop_row, hop_row + kTile, hops);
+      for (; j < kTile; ++j) {
+        int32_t candidate = PathLength(through, b_row[j]);
+        int32_t improved = -static_cast<int32_t>(candidate < cells[j]);
+        cells[j] = std::min(cells[j], candidate);
+        hops[j] = (hop & improved) | (hops[j] & ~improved);
+      }
+      std::copy(cells, cells + kTile, c_row);
+      std::copy(hops, hops + kTile, hop_row);
+#endif
+    }
+  }
+}
+
+// RelaxTile for a tile aliasing neither of the others, which lets each row
+// of c stay in registers while k runs over the whole middle tile
+void RelaxIndependentTile(TiledMatrix& distances, size_t row, size_t column,
+                          size_t middle) {
+  size_t stride = distances.Stride();
+  int32_t* c = distances.Tile(row, column);
+  const int32_t* a = distances.Tile(row, middle);
+  const int32_t* b = distances.Tile(middle, column);
+  for (size_t i = 0; i < kTile; ++i) {
+    int32_t* c_row = c + i * stride;
+    const int32_t* a_row = a + i * stride;
+#ifdef __AVX2__
+    const size_t kLanes = kTile / 8;
+    __m256i cells[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      cells[lane] =
+          _mm256_load_si256(reinterpret_cast<const __m256i*>(c_row) + lane);
+    }
+    for (size_t k = 0; k < kTile; ++k) {
+      if (a_row[k] == kUnreachable) {
+        continue;
+      }
+      __m256i through = _mm256_set1_epi32(a_row[k]);
+      auto b_row = reinterpret_cast<const __m256i*>(b + k * stride);
+      for (size_t lane = 0; lane < kLanes; ++lane) {
+        cells[lane] = _mm256_min_epi32(
+            cells[lane], PathLength(through, _mm256_load_si256(b_row + lane)));
+      }
+    }
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      _mm256_store_si256(reinterpret_cast<__m256i*>(c_row) + lane,
+                         cells[lane]);
+    }
+#else
+    // A local row cannot alias b, so the compiler vectorizes this loop
+    int32_t cells[kTile];
+    std::copy(c_row, c_row + kTile, cells);
+    for (size_t k = 0; k < kTile; ++k) {
+      int32_t through = a_row[k];
+      if (through == kUnreachable) {
+        continue;
+      }
+      const int32_t* b_row = b + k * stride;
+      for (size_t j = 0; j < kTile; ++j) {
+        cells[j] = std::min(cells[j], PathLength(through, b_row[j]));
+      }
+    }
+    std::copy(cells, cells + kTile, c_row);
+#endif
+  }
+}
+
+}  // namespace
+
+TiledMatrix::TiledMatrix(size_t num_vertices, int32_t value)
+    : num_vertices_(num_vertices),
+      stride_(std::max<size_t>(1, (num_vertices + kTile - 1) / kTile) *
+              kTile) {
+  size_t cells = stride_ * stride_;
+  cells_.reset(
+      static_cast<int32_t*>(std::aligned_alloc(64, cells * sizeof(int32_t))));
+  assert(cells_ != nullptr);
+  std::fill(cells_.get(), cells_.get() + cells, value);
+}
+
+bool FloydWarshall(TiledMatrix& distances, size_t num_threads,
+                   TiledMatrix* next_hops) {
+  size_t num_vertices = distances.VerticesCount();
+  size_t tiles = distances.TilesCount();
+  // Padding must not offer paths, whatever the matrix was filled with
+  for (Vertex from = 0; from < distances.Stride(); ++from) {
+    for (Vertex to = from < num_vertices ? num_vertices : 0;
+         to < distances.Stride(); ++to) {
+      distances.Set(from, to, kUnreachable);
+    }
+  }
+  if (next_hops != nullptr) {
+    *next_hops = TiledMatrix(num_vertices, kNoHop);
+    for (Vertex from = 0; from < num_vertices; ++from) {
+      for (Vertex to = 0; to < num_vertices; ++to) {
+        if (distances.Get(from, to) != kUnreachable) {
+          next_hops->Set(from, to, static_cast<int32_t>(to));
+        }
+      }
+    }
+  }
+  // Without hops every phase-3 tile can use the register-blocked kernel
+  auto relax_independent = [&](size_t row, size_t column, size_t middle) {
+    if (next_hops == nullptr) {
+      RelaxIndependentTile(distances, row, column, middle);
+    } else {
+      RelaxTile(distances, next_hops, row, column, middle);
+    }
+  };
+  for (size_t middle = 0; middle < tiles; ++middle) {
+    RelaxTile(distances, next_hops, middle, middle, middle);
+    // The middle tile's row and column: 2 (tiles - 1) independent tiles
+    ParallelFor(0, 2 * (tiles - 1), num_threads,
+                [&](size_t begin, size_t end, size_t) {
+                  for (size_t index = begin; index < end; ++index) {
+                    size_t other = index % (tiles - 1);
+                    other += other >= middle ? 1 : 0;
+                    if (index < tiles - 1) {
+                      RelaxTile(distances, next_hops, middle, other, middle);
+                    } else {
+                      RelaxTile(distances, next_hops, other, middle, middle);
+                    }
+                  }
+                });
+    // Everything else reads only the tiles finished above
+    ParallelFor(0, (tiles - 1) * (tiles - 1), num_threads,
+                [&](size_t begin, size_t end, size_t) {
+                  for (size_t index = begin; index < end; ++index) {
+                    size_t row = index / (tiles - 1);
+                    size_t column = index % (tiles - 1);
+                    row += row >= middle ? 1 : 0;
+                    column += column >= middle ? 1 : 0;
+                    relax_independent(row, column, middle);
+                  }
+                });
+  }
+  for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+    if (distances.Get(vertex, vertex) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<Vertex> RestorePath(const TiledMatrix& next_hops, Vertex from,
+                                Vertex to) {
+  std::vector<Vertex> path;
+  if (next_hops.Get(from, to) == kNoHop) {
+    return path;
+  }
+  path.push_back(from);
+  while (from != to) {
+    from = next_hops.Get(from, to);
+    path.push_back(from);
+    assert(path.size() <= next_hops.VerticesCount());
+  }
+  return path;
+}
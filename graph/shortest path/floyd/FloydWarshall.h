@@ -0,0 +1,76 @@
+#ifndef FLOYD_FLOYDWARSHALL_H
+#define FLOYD_FLOYDWARSHALL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "../../graphs/IGraph.h"
+#include "../../graphs/Parallel.h"
+
+// No path; also what a path longer than the int32 range saturates to
+const int32_t kUnreachable = std::numeric_limits<int32_t>::max();
+// Next hop of a pair with no path
+const int32_t kNoHop = -1;
+
+// Square int32 matrix in one row-major block. Rows are padded to a whole
+// number of kTile x kTile tiles and start on 64-byte boundaries; padding
+// cells hold the fill value.
+class TiledMatrix {
+ public:
+  static constexpr size_t kTile = 64;
+
+  TiledMatrix(size_t num_vertices, int32_t value);
+
+  size_t VerticesCount() const { return num_vertices_; }
+
+  // Tiles per row (and per column)
+  size_t TilesCount() const { return stride_ / kTile; }
+
+  size_t Stride() const { return stride_; }
+
+  int32_t Get(Vertex from, Vertex to) const {
+    return cells_.get()[from * stride_ + to];
+  }
+
+  void Set(Vertex from, Vertex to, int32_t value) {
+    cells_.get()[from * stride_ + to] = value;
+  }
+
+  // Top-left cell of tile (row, column); rows of the tile are Stride() apart
+  int32_t* Tile(size_t row, size_t column) {
+    return cells_.get() + (row * stride_ + column) * kTile;
+  }
+
+ private:
+  struct AlignedFree {
+    void operator()(int32_t* pointer) const { std::free(pointer); }
+  };
+
+  size_t num_vertices_;
+  size_t stride_;
+  std::unique_ptr<int32_t[], AlignedFree> cells_;
+};
+
+// All-pairs shortest paths in place: distances holds edge lengths
+// (kUnreachable where there is no edge) and gets path lengths. Blocked
+// Floyd-Warshall: for each diagonal tile, the tile itself, then its row and
+// column of tiles, then all the rest, the last two phases spread over
+// threads. Sums saturate instead of wrapping, and kUnreachable absorbs
+// negative lengths.
+//
+// If next_hops is given it receives, for every pair, the vertex after
+// `from` on a shortest path (kNoHop if there is none); see RestorePath.
+// Returns false if the graph has a negative cycle, in which case the
+// lengths are not shortest distances.
+bool FloydWarshall(TiledMatrix& distances,
+                   size_t num_threads = DefaultThreadsCount(),
+                   TiledMatrix* next_hops = nullptr);
+
+// Vertices of a shortest from -> to path, both ends included; empty if
+// there is none
+std::vector<Vertex> RestorePath(const TiledMatrix& next_hops, Vertex from,
+                                Vertex to);
+
+#endif  // FLOYD_FLOYDWARSHALL_H
@@ -0,0 +1,96 @@
+// Times the tiled FloydWarshall against the textbook triple loop over
+// std::vector<std::vector<int>> it replaced, with and without next hops.
+//
+// Usage: benchmark [num_vertices] [num_threads]
+// The input is a random digraph with 10% of the pairs joined by edges of
+// length [1, 1000]; the baseline uses a large finite "infinity".
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../FloydWarshall.h"
+
+const int kBaselineInfinity = 1000000000;
+
+// The original FloydAlgo, kept as the baseline
+void FloydAlgo(std::vector<std::vector<int>>& matrix) {
+  for (size_t k = 0; k < matrix.size(); ++k) {
+    for (size_t i = 0; i < matrix.size(); ++i) {
+      for (size_t j = 0; j < matrix.size(); ++j) {
+        matrix[i][j] = std::min(matrix[i][j], matrix[i][k] + matrix[k][j]);
+      }
+    }
+  }
+}
+
+template <typename Function>
+double Measure(const std::string& name, Function function) {
+  auto start = std::chrono::steady_clock::now();
+  function();
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  std::cout << name << ": " << seconds << " s" << std::endl;
+  return seconds;
+}
+
+int main(int argc, char** argv) {
+  size_t num_vertices =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+  size_t num_threads =
+      argc > 2 ? std::strtoull(argv[2], nullptr, 10) : DefaultThreadsCount();
+
+  std::mt19937_64 generator(42);
+  std::bernoulli_distribution has_edge(0.1);
+  std::uniform_int_distribution<int> weight(1, 1000);
+  auto baseline = std::vector<std::vector<int>>(
+      num_vertices, std::vector<int>(num_vertices, kBaselineInfinity));
+  TiledMatrix distances(num_vertices, kUnreachable);
+  for (Vertex from = 0; from < num_vertices; ++from) {
+    baseline[from][from] = 0;
+    distances.Set(from, from, 0);
+    for (Vertex to = 0; to < num_vertices; ++to) {
+      if (from != to && has_edge(generator)) {
+        baseline[from][to] = weight(generator);
+        distances.Set(from, to, baseline[from][to]);
+      }
+    }
+  }
+  TiledMatrix with_hops(num_vertices, kUnreachable);
+  for (Vertex from = 0; from < num_vertices; ++from) {
+    for (Vertex to = 0; to < num_vertices; ++to) {
+      with_hops.Set(from, to, distances.Get(from, to));
+    }
+  }
+  std::cout << num_vertices << " vertices, " << num_threads << " threads"
+            << std::endl;
+
+  double textbook = Measure("FloydAlgo", [&] { FloydAlgo(baseline); });
+  double tiled = Measure("FloydWarshall",
+                         [&] { FloydWarshall(distances, num_threads); });
+  std::cout << "  speedup x" << textbook / tiled << std::endl;
+  TiledMatrix next_hops(0, kNoHop);
+  double hops = Measure("FloydWarshall with next hops", [&] {
+    FloydWarshall(with_hops, num_threads, &next_hops);
+  });
+  std::cout << "  speedup x" << textbook / hops << std::endl;
+
+  bool ok = true;
+  for (Vertex from = 0; from < num_vertices && ok; ++from) {
+    for (Vertex to = 0; to < num_vertices; ++to) {
+      int expected = baseline[from][to] >= kBaselineInfinity
+                         ? kUnreachable
+                         : baseline[from][to];
+      if (distances.Get(from, to) != expected ||
+          with_hops.Get(from, to) != expected) {
+        ok = false;
+        break;
+      }
+    }
+  }
+  std::cout << (ok ? "results agree" : "results differ") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,284 @@
+#ifndef FORD_BELLMAN_BELLMANFORD_H
+#define FORD_BELLMAN_BELLMANFORD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "../../graphs/IGraph.h"
+#include "../../graphs/Parallel.h"
+
+enum class BellmanFordMode {
+  // In-place rounds over the vertices whose distance dropped in the
+  // previous round, until a round changes nothing
+  Sweep,
+  // SPFA: a FIFO queue of vertices whose distance dropped; a negative cycle
+  // shows as a path of V or more edges
+  Queue,
+  // Rounds in which every vertex pulls from its in-edges, split across
+  // threads
+  ParallelSweep
+};
+
+template <typename Weight>
+struct WeightedEdge {
+  Vertex from;
+  Vertex to;
+  Weight weight;
+};
+
+template <typename Weight>
+struct BellmanFordResult {
+  static constexpr Weight kUnreached = std::numeric_limits<Weight>::max();
+  static constexpr Vertex kNoParent = std::numeric_limits<Vertex>::max();
+
+  bool HasNegativeCycle() const { return !negative_cycle.empty(); }
+
+  // Not final if there is a negative cycle
+  std::vector<Weight> distance;
+  std::vector<Vertex> parent;
+  // A negative cycle reachable from the sources in edge order: the last
+  // vertex has an edge back to the first
+  std::vector<Vertex> negative_cycle;
+};
+
+// Single-source shortest paths with negative weights over flat CSR arrays.
+// Every mode stops as soon as distances settle; while they keep changing
+// past V - 1 rounds (or V edges on a path), the parent pointers are
+// searched for a cycle, which then has negative weight.
+template <typename Weight>
+class BellmanFord {
+ public:
+  using Result = BellmanFordResult<Weight>;
+
+  BellmanFord(size_t num_vertices,
+              const std::vector<WeightedEdge<Weight>>& edges)
+      : next_offsets_(num_vertices + 1, 0),
+        prev_offsets_(num_vertices + 1, 0),
+        next_targets_(edges.size()),
+        next_weights_(edges.size()),
+        prev_sources_(edges.size()),
+        prev_weights_(edges.size()) {
+    for (const auto& edge : edges) {
+      ++next_offsets_[edge.from + 1];
+      ++prev_offsets_[edge.to + 1];
+    }
+    for (Vertex vertex = 0; vertex < num_vertices; ++vertex) {
+      next_offsets_[vertex + 1] += next_offsets_[vertex];
+      prev_offsets_[vertex + 1] += prev_offsets_[vertex];
+    }
+    auto next_fill = std::vector<size_t>(next_offsets_.begin(),
+                                         next_offsets_.end() - 1);
+    auto prev_fill = std::vector<size_t>(prev_offsets_.begin(),
+                                         prev_offsets_.end() - 1);
+    for (const auto& edge : edges) {
+      next_targets_[next_fill[edge.from]] = edge.to;
+      next_weights_[next_fill[edge.from]++] = edge.weight;
+      prev_sources_[prev_fill[edge.to]] = edge.from;
+      prev_weights_[prev_fill[edge.to]++] = edge.weight;
+    }
+  }
+
+  size_t VerticesCount() const { return next_offsets_.size() - 1; }
+
+  Result Run(Vertex source, BellmanFordMode mode = BellmanFordMode::Queue,
+             size_t num_threads = DefaultThreadsCount()) const {
+    return Run(std::vector<Vertex>(1, source), mode, num_threads);
+  }
+
+  // All sources start at distance 0
+  Result Run(const std::vector<Vertex>& sources,
+             BellmanFordMode mode = BellmanFordMode::Queue,
+             size_t num_threads = DefaultThreadsCount()) const {
+    Result result;
+    result.distance.assign(VerticesCount(), Result::kUnreached);
+    result.parent.assign(VerticesCount(), Result::kNoParent);
+    for (auto source : sources) {
+      result.distance[source] = 0;
+    }
+    switch (mode) {
+      case BellmanFordMode::Sweep:
+        Sweep(sources, result);
+        break;
+      case BellmanFordMode::Queue:
+        Queue(sources, result);
+        break;
+      default:
+        ParallelSweep(result, num_threads);
+    }
+    return result;
+  }
+
+  // Every vertex a source: distances are then the potentials Johnson's
+  // reweighting needs, and any negative cycle in the graph is found
+  Result RunFromAll(BellmanFordMode mode = BellmanFordMode::Queue,
+                    size_t num_threads = DefaultThreadsCount()) const {
+    auto sources = std::vector<Vertex>(VerticesCount());
+    for (Vertex vertex = 0; vertex < sources.size(); ++vertex) {
+      sources[vertex] = vertex;
+    }
+    return Run(sources, mode, num_threads);
+  }
+
+ private:
+  void Sweep(const std::vector<Vertex>& sources, Result& result) const {
+    auto& distance = result.distance;
+    auto& parent = result.parent;
+    auto active = std::vector<char>(VerticesCount(), 0);
+    for (auto source : sources) {
+      active[source] = 1;
+    }
+    auto updated = std::vector<Vertex>();
+    for (size_t round = 1;; ++round) {
+      updated.clear();
+      for (Vertex from = 0; from < VerticesCount(); ++from) {
+        if (!active[from]) {
+          continue;
+        }
+        active[from] = 0;
+        for (size_t i = next_offsets_[from]; i < next_offsets_[from + 1];
+             ++i) {
+          Vertex to = next_targets_[i];
+          Weight candidate = distance[from] + next_weights_[i];
+          if (candidate < distance[to]) {
+            distance[to] = candidate;
+            parent[to] = from;
+            active[to] = 1;
+            updated.push_back(to);
+          }
+        }
+      }
+      if (updated.empty() ||
+          (round >= VerticesCount() &&
+           FindParentCycle(parent, updated, result.negative_cycle))) {
+        return;
+      }
+    }
+  }
+
+  void Queue(const std::vector<Vertex>& sources, Result& result) const {
+    auto& distance = result.distance;
+    auto& parent = result.parent;
+    // Ring buffer: a vertex is queued at most once at a time
+    auto queue = std::vector<Vertex>(VerticesCount());
+    size_t head = 0;
+    size_t size = 0;
+    auto queued = std::vector<char>(VerticesCount(), 0);
+    auto edges_count = std::vector<size_t>(VerticesCount(), 0);
+    auto push = [&](Vertex vertex) {
+      queue[(head + size++) % queue.size()] = vertex;
+      queued[vertex] = 1;
+    };
+    for (auto source : sources) {
+      if (!queued[source]) {
+        push(source);
+      }
+    }
+    while (size > 0) {
+      Vertex from = queue[head];
+      head = (head + 1) % queue.size();
+      --size;
+      queued[from] = 0;
+      for (size_t i = next_offsets_[from]; i < next_offsets_[from + 1]; ++i) {
+        Vertex to = next_targets_[i];
+        Weight candidate = distance[from] + next_weights_[i];
+        if (candidate >= distance[to]) {
+          continue;
+        }
+        distance[to] = candidate;
+        parent[to] = from;
+        edges_count[to] = edges_count[from] + 1;
+        if (edges_count[to] >= VerticesCount() &&
+            FindParentCycle(parent, std::vector<Vertex>(1, to),
+                            result.negative_cycle)) {
+          return;
+        }
+        if (!queued[to]) {
+          push(to);
+        }
+      }
+    }
+  }
+
+  void ParallelSweep(Result& result, size_t num_threads) const {
+    auto& parent = result.parent;
+    auto distance = result.distance;
+    auto next_distance = distance;
+    auto changed = std::vector<char>(VerticesCount(), 0);
+    // Round r leaves the shortest walks of at most r edges, so a change in
+    // round V proves a negative cycle
+    for (size_t round = 1;; ++round) {
+      ParallelFor(0, VerticesCount(), num_threads,
+                  [&](size_t begin, size_t end, size_t) {
+                    for (Vertex to = begin; to < end; ++to) {
+                      Weight best = distance[to];
+                      changed[to] = 0;
+                      for (size_t i = prev_offsets_[to];
+                           i < prev_offsets_[to + 1]; ++i) {
+                        Vertex from = prev_sources_[i];
+                        if (distance[from] == Result::kUnreached) {
+                          continue;
+                        }
+                        Weight candidate = distance[from] + prev_weights_[i];
+                        if (candidate < best) {
+                          best = candidate;
+                          parent[to] = from;
+                          changed[to] = 1;
+                        }
+                      }
+                      next_distance[to] = best;
+                    }
+                  });
+      distance.swap(next_distance);
+      auto updated = std::vector<Vertex>();
+      for (Vertex vertex = 0; vertex < VerticesCount(); ++vertex) {
+        if (changed[vertex]) {
+          updated.push_back(vertex);
+        }
+      }
+      if (updated.empty() ||
+          (round >= VerticesCount() &&
+           FindParentCycle(parent, updated, result.negative_cycle))) {
+        break;
+      }
+    }
+    result.distance = std::move(distance);
+  }
+
+  // Follows parent pointers from each start; the walks share marks, so the
+  // whole search is linear. Fills cycle in edge order if one is met.
+  bool FindParentCycle(const std::vector<Vertex>& parent,
+                       const std::vector<Vertex>& starts,
+                       std::vector<Vertex>& cycle) const {
+    auto walk = std::vector<size_t>(VerticesCount(), 0);
+    for (size_t i = 0; i < starts.size(); ++i) {
+      Vertex vertex = starts[i];
+      while (vertex != Result::kNoParent && walk[vertex] == 0) {
+        walk[vertex] = i + 1;
+        vertex = parent[vertex];
+      }
+      if (vertex == Result::kNoParent || walk[vertex] != i + 1) {
+        continue;
+      }
+      // Back on this walk's own trail: vertex lies on a cycle
+      cycle.clear();
+      Vertex current = vertex;
+      do {
+        cycle.push_back(current);
+        current = parent[current];
+      } while (current != vertex);
+      std::reverse(cycle.begin(), cycle.end());
+      return true;
+    }
+    return false;
+  }
+
+  std::vector<size_t> next_offsets_;
+  std::vector<size_t> prev_offsets_;
+  std::vector<Vertex> next_targets_;
+  std::vector<Weight> next_weights_;
+  std::vector<Vertex> prev_sources_;
+  std::vector<Weight> prev_weights_;
+};
+
+#endif  // FORD_BELLMAN_BELLMANFORD_H
@@ -1,18 +1,15 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
-#include <queue>
-#include <set>
-#include <stack>
-#include <unordered_map>
-#include <unordered_set>
+#include <tuple>
 #include <vector>
+#include "../../graphs/GraphBuilder.h"
+#include "../../graphs/StronglyConnectedComponents.h"
+#include "BellmanFord.h"
 
-using Vertex = std::size_t;
-
-class ListGraph {
+class WeightedGraph {
  public:
-  explicit ListGraph(const size_t num_vertices)
+  explicit WeightedGraph(const size_t num_vertices)
       : next_vertices_(num_vertices, std::vector<std::tuple<Vertex, float>>()),
         prev_vertices_(num_vertices, std::vector<std::tuple<Vertex, float>>()) {
   }
@@ -27,147 +24,83 @@ class ListGraph {
   void GetPrevVertices(Vertex vertex,
                        std::vector<std::tuple<Vertex, float>>& vertices) const;
 
-  void CondenseGraph() const;
-
-  bool FindNegativeWeightCycle() const;
+  // Vertices of a negative cycle in edge order; empty if there is none
+  std::vector<Vertex> FindNegativeWeightCycle() const;
 
  private:
-  bool FindNegativeCycleFordBellman(std::vector<Vertex>& vertices) const;
-
-  void FindTraversalVector() const;
-
-  void TransposedDepthFirstSearch(Vertex from) const;
-
-  void DepthFirstSearch(Vertex from) const;
-
-  void FindStrongConnectedComponents() const;
-
-  mutable std::unordered_map<Vertex, Vertex> convert_to_condensed_;
-  mutable std::vector<bool> visited_;
-  mutable std::vector<std::vector<Vertex>> strong_connected_components_;
-  mutable std::vector<Vertex> traversal_vector_;
-  mutable std::vector<Vertex> current_component_;
   std::vector<std::vector<std::tuple<Vertex, float>>> next_vertices_;
   std::vector<std::vector<std::tuple<Vertex, float>>> prev_vertices_;
 };
 
-void ListGraph::AddEdge(Vertex from, Vertex to, float weight) {
+void WeightedGraph::AddEdge(Vertex from, Vertex to, float weight) {
   assert(0 <= from && from < VerticesCount());
   assert(0 <= to && to < VerticesCount());
   next_vertices_[from].emplace_back(to, weight);
   prev_vertices_[to].emplace_back(from, weight);
 }
 
-void ListGraph::GetNextVertices(
+void WeightedGraph::GetNextVertices(
     Vertex vertex, std::vector<std::tuple<Vertex, float>>& vertices) const {
   vertices = next_vertices_[vertex];
 }
 
-void ListGraph::GetPrevVertices(
+void WeightedGraph::GetPrevVertices(
     Vertex vertex, std::vector<std::tuple<Vertex, float>>& vertices) const {
   vertices = prev_vertices_[vertex];
 }
 
-void ListGraph::FindTraversalVector() const {
-  for (Vertex vertex = 0; vertex < VerticesCount(); ++vertex) {
-    if (!visited_[vertex]) {
-      TransposedDepthFirstSearch(vertex);
+std::vector<Vertex> WeightedGraph::FindNegativeWeightCycle() const {
+  GraphBuilder builder(VerticesCount());
+  for (Vertex from = 0; from < VerticesCount(); ++from) {
+    for (auto [to, weight] : next_vertices_[from]) {
+      builder.AddEdge(from, to);
     }
   }
-}
-
-void ListGraph::DepthFirstSearch(Vertex from) const {
-  visited_[from] = true;
-  current_component_.emplace_back(from);
-  for (auto [vertex, weight] : next_vertices_[from]) {
-    if (!visited_[vertex]) {
-      DepthFirstSearch(vertex);
+  auto components = FindStronglyConnectedComponents(builder.BuildCSRGraph());
+
+  // A cycle never leaves its strongly connected component, so each one is
+  // checked on its own edges, renumbered from 0
+  std::vector<Vertex> local(VerticesCount());
+  for (size_t id = 0; id < components.ComponentsCount(); ++id) {
+    auto vertices = components.ComponentVertices(id);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      local[vertices[i]] = i;
     }
   }
-}
-
-void ListGraph::TransposedDepthFirstSearch(Vertex from) const {
-  visited_[from] = true;
-  for (auto [vertex, weight] : prev_vertices_[from]) {
-    if (!visited_[vertex]) {
-      TransposedDepthFirstSearch(vertex);
-    }
-  }
-  traversal_vector_.emplace_back(from);
-}
-
-void ListGraph::CondenseGraph() const {
-  visited_.assign(VerticesCount(), false);
-  FindTraversalVector();
-  visited_.assign(VerticesCount(), false);
-  FindStrongConnectedComponents();
-}
-
-void ListGraph::FindStrongConnectedComponents() const {
-  for (int64_t i = traversal_vector_.size() - 1; i >= 0; --i) {
-    if (!visited_[traversal_vector_[i]]) {
-      DepthFirstSearch(traversal_vector_[i]);
-      strong_connected_components_.emplace_back(current_component_);
-      current_component_.clear();
-    }
-  }
-}
-
-bool ListGraph::FindNegativeCycleFordBellman(
-    std::vector<Vertex>& vertices) const {
-  std::unordered_map<Vertex, bool> is_in_component;
-  std::vector<std::tuple<Vertex, Vertex, float>> edges;
-  std::unordered_map<Vertex, float> min_path;
-  const uint64_t inf = 100000000;
-
-  for (Vertex current = 0; current < VerticesCount(); ++current) {
-    is_in_component[current] = false;
-  }
-
-  for (auto vertex : vertices) {
-    is_in_component[vertex] = true;
-    min_path[vertex] = inf;
-  }
-
-  for (auto current : vertices) {
-    for (auto [next, weight] : next_vertices_[current]) {
-      if (is_in_component[next]) {
-        edges.emplace_back(next, current, weight);
+  auto edges = std::vector<std::vector<WeightedEdge<float>>>(
+      components.ComponentsCount());
+  for (Vertex from = 0; from < VerticesCount(); ++from) {
+    for (auto [to, weight] : next_vertices_[from]) {
+      size_t id = components.component[from];
+      if (components.component[to] == id) {
+        edges[id].push_back({local[from], local[to], weight});
       }
     }
   }
 
-  min_path[*vertices.begin()] = 1;
-  bool last_vertex_changed = false;
-
-  for (auto vertex : vertices) {
-    last_vertex_changed = false;
-    for (auto [from, to, weight] : edges) {
-      if (min_path[from] < inf) {
-        if (min_path[to] > min_path[from] + weight) {
-          min_path[to] = min_path[from] + weight;
-          last_vertex_changed = true;
-        }
-      }
+  for (size_t id = 0; id < components.ComponentsCount(); ++id) {
+    if (edges[id].empty()) {
+      continue;
     }
-  }
-  return last_vertex_changed;
-}
-
-bool ListGraph::FindNegativeWeightCycle() const {
-  CondenseGraph();
-  for (auto component : strong_connected_components_) {
-    if (FindNegativeCycleFordBellman(component)) {
-      return true;
+    auto vertices = components.ComponentVertices(id);
+    BellmanFord<float> bellman_ford(vertices.size(), edges[id]);
+    // Every vertex of the component reaches all the others, so any source
+    // would do; starting from all of them settles fastest
+    auto cycle = bellman_ford.RunFromAll().negative_cycle;
+    if (!cycle.empty()) {
+      for (auto& vertex : cycle) {
+        vertex = vertices[vertex];
+      }
+      return cycle;
     }
   }
-  return false;
+  return {};
 }
 
 int main() {
   size_t num_vertices = 0;
   std::cin >> num_vertices;
-  auto graph = ListGraph(num_vertices);
+  auto graph = WeightedGraph(num_vertices);
 
   for (size_t i = 0; i < num_vertices; ++i) {
     for (size_t j = 0; j < num_vertices; ++j) {
@@ -181,6 +114,7 @@ int main() {
     }
   }
 
-  std::cout << (graph.FindNegativeWeightCycle() ? "YES" : "NO") << std::endl;
+  std::cout << (graph.FindNegativeWeightCycle().empty() ? "NO" : "YES")
+            << std::endl;
   return 0;
 }
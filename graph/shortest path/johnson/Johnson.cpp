@@ -0,0 +1,165 @@
+#include "Johnson.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+
+namespace {
+
+// "APSP" little-endian
+const uint32_t kDistancesMagic = 0x50535041;
+const uint32_t kDistancesVersion = 1;
+
+struct DistancesHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t num_vertices;
+};
+
+}  // namespace
+
+JohnsonAllPairs::JohnsonAllPairs(
+    size_t num_vertices, const std::vector<WeightedEdge<int64_t>>& edges,
+    size_t num_threads)
+    : num_threads_(std::max<size_t>(1, num_threads)) {
+  // Starting from every vertex at 0 is the classic extra source with
+  // zero-weight edges to all vertices, without building it
+  auto potentials = BellmanFord<int64_t>(num_vertices, edges).RunFromAll();
+  potential_ = std::move(potentials.distance);
+  negative_cycle_ = std::move(potentials.negative_cycle);
+  if (HasNegativeCycle()) {
+    return;
+  }
+  WeightedList reweighted(num_vertices);
+  for (const auto& edge : edges) {
+    int64_t weight = edge.weight + potential_[edge.from] - potential_[edge.to];
+    assert(weight >= 0);
+    reweighted[edge.from].emplace_back(edge.to, static_cast<size_t>(weight));
+  }
+  engine_ = std::make_unique<ShortestPathEngine>(reweighted, num_threads_);
+  workspaces_.push_back(engine_->CreateWorkspace());
+}
+
+template <typename Body>
+void JohnsonAllPairs::ForEachSource(Body body) {
+  size_t num_threads =
+      std::min(num_threads_, std::max<size_t>(1, VerticesCount()));
+  while (workspaces_.size() < num_threads) {
+    workspaces_.push_back(engine_->CreateWorkspace());
+  }
+  std::atomic<Vertex> next_source(0);
+  ParallelFor(0, num_threads, num_threads, [&](size_t, size_t, size_t thread) {
+    std::vector<size_t> reweighted;
+    for (Vertex source = next_source++; source < VerticesCount();
+         source = next_source++) {
+      engine_->FindDistances(source, workspaces_[thread], reweighted);
+      body(source, reweighted);
+    }
+  });
+}
+
+void JohnsonAllPairs::RestoreRow(Vertex source,
+                                 const std::vector<size_t>& reweighted,
+                                 int64_t* row) const {
+  for (Vertex to = 0; to < VerticesCount(); ++to) {
+    row[to] = reweighted[to] == kInfinity
+                  ? kNoPath
+                  : static_cast<int64_t>(reweighted[to]) - potential_[source] +
+                        potential_[to];
+  }
+}
+
+void JohnsonAllPairs::FindRow(Vertex source, std::vector<int64_t>& row) {
+  assert(!HasNegativeCycle());
+  std::vector<size_t> reweighted;
+  engine_->FindDistances(source, workspaces_.front(), reweighted);
+  row.resize(VerticesCount());
+  RestoreRow(source, reweighted, row.data());
+}
+
+void JohnsonAllPairs::ForEachRow(const RowCallback& callback) {
+  assert(!HasNegativeCycle());
+  std::mutex callback_mutex;
+  ForEachSource([&](Vertex source, const std::vector<size_t>& reweighted) {
+    // Restored before taking the lock, so only the callback is serialized
+    auto row = std::vector<int64_t>(VerticesCount());
+    RestoreRow(source, reweighted, row.data());
+    std::lock_guard<std::mutex> lock(callback_mutex);
+    callback(source, row);
+  });
+}
+
+bool JohnsonAllPairs::WriteFile(const std::string& path) {
+  assert(!HasNegativeCycle());
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  size_t size = sizeof(DistancesHeader) +
+                sizeof(int64_t) * VerticesCount() * VerticesCount();
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  auto header = static_cast<DistancesHeader*>(data);
+  *header = {kDistancesMagic, kDistancesVersion, VerticesCount()};
+  auto rows = reinterpret_cast<int64_t*>(header + 1);
+
+  ForEachSource([&](Vertex source, const std::vector<size_t>& reweighted) {
+    RestoreRow(source, reweighted, rows + source * VerticesCount());
+  });
+  return munmap(data, size) == 0;
+}
+
+MappedDistances::~MappedDistances() { Close(); }
+
+bool MappedDistances::Open(const std::string& path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(DistancesHeader)) {
+    close(fd);
+    return false;
+  }
+  size_ = file_stat.st_size;
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    return false;
+  }
+  auto header = static_cast<const DistancesHeader*>(data_);
+  size_t vertices = header->num_vertices;
+  if (header->magic != kDistancesMagic ||
+      header->version != kDistancesVersion ||
+      size_ != sizeof(DistancesHeader) +
+                   sizeof(int64_t) * vertices * vertices) {
+    Close();
+    return false;
+  }
+  num_vertices_ = vertices;
+  rows_ = reinterpret_cast<const int64_t*>(header + 1);
+  return true;
+}
+
+void MappedDistances::Close() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  num_vertices_ = 0;
+  rows_ = nullptr;
+}
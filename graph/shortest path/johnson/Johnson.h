@@ -0,0 +1,100 @@
+#ifndef JOHNSON_JOHNSON_H
+#define JOHNSON_JOHNSON_H
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../dijkstra/ShortestPathEngine.h"
+#include "../ford-bellman/BellmanFord.h"
+
+// Distance between vertices with no path between them
+const int64_t kNoPath = std::numeric_limits<int64_t>::max();
+
+// All-pairs shortest paths on a sparse graph with negative edges. One
+// Bellman-Ford run from every vertex at once gives potentials h with
+// w(u, v) + h(u) - h(v) >= 0 on every edge; after that each row is a plain
+// Dijkstra on the reweighted graph, and rows are computed in parallel and
+// handed out one at a time, so no V x V matrix is ever held in memory.
+class JohnsonAllPairs {
+ public:
+  using RowCallback = std::function<void(Vertex, const std::vector<int64_t>&)>;
+
+  JohnsonAllPairs(size_t num_vertices,
+                  const std::vector<WeightedEdge<int64_t>>& edges,
+                  size_t num_threads = DefaultThreadsCount());
+
+  size_t VerticesCount() const { return potential_.size(); }
+
+  // No distances are defined then
+  bool HasNegativeCycle() const { return !negative_cycle_.empty(); }
+
+  // In edge order: the last vertex has an edge back to the first
+  const std::vector<Vertex>& NegativeCycle() const { return negative_cycle_; }
+
+  // row[to] is the distance from source, or kNoPath
+  void FindRow(Vertex source, std::vector<int64_t>& row);
+
+  // Calls callback(source, row) once per source. Rows are computed in
+  // parallel and arrive in no particular order, but the calls never
+  // overlap; row is only valid during its call.
+  void ForEachRow(const RowCallback& callback);
+
+  // Writes all rows into a file of VerticesCount()^2 int64 cells after a
+  // small header (see MappedDistances); every thread stores its rows
+  // straight into a shared mapping of the file
+  bool WriteFile(const std::string& path);
+
+ private:
+  // Calls body(source, reweighted_distances) for every source, with
+  // threads pulling sources from a shared counter
+  template <typename Body>
+  void ForEachSource(Body body);
+
+  // Undoes the reweighting on a row of reweighted distances
+  void RestoreRow(Vertex source, const std::vector<size_t>& reweighted,
+                  int64_t* row) const;
+
+  std::vector<int64_t> potential_;
+  std::vector<Vertex> negative_cycle_;
+  // Over the reweighted edges; absent if there is a negative cycle
+  std::unique_ptr<ShortestPathEngine> engine_;
+  size_t num_threads_;
+  std::vector<ShortestPathEngine::Workspace> workspaces_;
+};
+
+// Read-only view of a file made by JohnsonAllPairs::WriteFile
+class MappedDistances {
+ public:
+  MappedDistances() = default;
+
+  MappedDistances(const MappedDistances&) = delete;
+
+  MappedDistances& operator=(const MappedDistances&) = delete;
+
+  ~MappedDistances();
+
+  bool Open(const std::string& path);
+
+  void Close();
+
+  size_t VerticesCount() const { return num_vertices_; }
+
+  int64_t Get(Vertex from, Vertex to) const {
+    return rows_[from * num_vertices_ + to];
+  }
+
+  const int64_t* Row(Vertex from) const {
+    return rows_ + from * num_vertices_;
+  }
+
+ private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  size_t num_vertices_ = 0;
+  const int64_t* rows_ = nullptr;
+};
+
+#endif  // JOHNSON_JOHNSON_H
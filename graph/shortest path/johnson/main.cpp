@@ -0,0 +1,44 @@
+#include <iostream>
+#include <vector>
+#include "Johnson.h"
+
+// Reads a directed graph as "V E" and E lines "from to weight" (weights may
+// be negative). Prints the V x V distance matrix, "-" for no path, or the
+// vertices of a negative cycle. With a path argument, writes the matrix to
+// that file instead (see MappedDistances).
+int main(int argc, char** argv) {
+  size_t num_vertices = 0;
+  size_t num_edges = 0;
+  std::cin >> num_vertices >> num_edges;
+
+  std::vector<WeightedEdge<int64_t>> edges(num_edges);
+  for (auto& edge : edges) {
+    std::cin >> edge.from >> edge.to >> edge.weight;
+  }
+
+  JohnsonAllPairs johnson(num_vertices, edges);
+  if (johnson.HasNegativeCycle()) {
+    std::cout << "NEGATIVE CYCLE";
+    for (auto vertex : johnson.NegativeCycle()) {
+      std::cout << ' ' << vertex;
+    }
+    std::cout << std::endl;
+    return 0;
+  }
+  if (argc > 1) {
+    return johnson.WriteFile(argv[1]) ? 0 : 1;
+  }
+  std::vector<int64_t> row;
+  for (Vertex from = 0; from < num_vertices; ++from) {
+    johnson.FindRow(from, row);
+    for (auto distance : row) {
+      if (distance == kNoPath) {
+        std::cout << "- ";
+      } else {
+        std::cout << distance << ' ';
+      }
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}